@@ -1,6 +1,567 @@
+// batch front end: parse every file given on the command line, directly, through directories or through list files, on a configurable number of threads, and report per file and aggregate bytes/sec, statement and error counts and peak memory
+
+
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <sys/resource.h>
+#include <time.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Result of a parser producing a T: the value and the remaining input
+template<typename T>
+using Result = optional<pair<T, string_view>>;
+
+// Define a parser combinator function type, generic over the result type.
+// The input is a view, so consuming characters never copies the rest of it.
+template<typename T>
+using Parser = function<Result<T>(string_view)>;
+
+// Value of rules that only recognize input
+struct Unit {};
+
+// Parser combinator function to parse a single character
+Parser<char> charParser(char c) {
+    return [c](string_view input) -> Result<char> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(c, input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Parser combinator function to parse any character of a set
+Parser<char> charSetParser(CharSet set) {
+    return [set](string_view input) -> Result<char> {
+        if (!input.empty() && set.contains(static_cast<unsigned char>(input[0]))) {
+            return make_pair(input[0], input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Map combinator: transform the value of a successful parse
+template<typename T, typename F>
+auto mapParser(Parser<T> parser, F f) -> Parser<decltype(f(declval<T>()))> {
+    using U = decltype(f(declval<T>()));
+    return [parser, f](string_view input) -> Result<U> {
+        if (auto result = parser(input); result) {
+            return make_pair(f(move(result->first)), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Sequence combinator: run the parsers one after another and collect their values in a tuple
+template<typename T, typename... Ts>
+Parser<tuple<T, Ts...>> seqParser(Parser<T> first, Parser<Ts>... rest) {
+    if constexpr (sizeof...(Ts) == 0) {
+        return mapParser(first, [](T value) { return tuple<T>(move(value)); });
+    } else {
+        Parser<tuple<Ts...>> others = seqParser(rest...);
+        return [first, others](string_view input) -> Result<tuple<T, Ts...>> {
+            auto firstResult = first(input);
+            if (!firstResult) return nullopt;
+
+            auto othersResult = others(firstResult->second);
+            if (!othersResult) return nullopt;
+
+            return make_pair(tuple_cat(tuple<T>(move(firstResult->first)), move(othersResult->first)),
+                             othersResult->second);
+        };
+    }
+}
+
+// OR combinator to combine multiple parsers of the same result type
+template<typename T, typename... Parsers>
+Parser<T> orParser(Parser<T> first, Parsers... rest) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser<T>> parserList = {first, rest...};
+    return [parserList](string_view input) -> Result<T> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Skip combinator: run the parser and drop its value
+template<typename T>
+Parser<Unit> skipParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        if (auto result = parser(input); result) {
+            return make_pair(Unit{}, result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Skip zero or more repetitions of a parser without collecting anything
+template<typename T>
+Parser<Unit> skipManyParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        while (auto result = parser(input)) {
+            if (result->second.size() == input.size()) break;
+            input = result->second;
+        }
+        return make_pair(Unit{}, input);
+    };
+}
+
+// Run ignored first, then parser, keeping only the value of parser
+template<typename T, typename U>
+Parser<U> ignoreThen(Parser<T> ignored, Parser<U> parser) {
+    return [ignored, parser](string_view input) -> Result<U> {
+        auto ignoredResult = ignored(input);
+        if (!ignoredResult) return nullopt;
+        return parser(ignoredResult->second);
+    };
+}
+
+// Span combinator: the value is the text the parser consumed, not whatever it built
+template<typename T>
+Parser<string_view> spanParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<string_view> {
+        if (auto result = parser(input); result) {
+            size_t length = input.size() - result->second.size();
+            return make_pair(input.substr(0, length), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+template<typename T>
+Parser<T> lexeme(Parser<T> parser) {
+    return ignoreThen(skipManyParser(charSetParser(spaces)), parser);
+}
+
+// Chain combinator for left recursive rules: operand (op operand)*, folded with combine
+template<typename T, typename F>
+Parser<T> chainLeftParser(Parser<T> operand, Parser<char> op, F combine) {
+    return [operand, op, combine](string_view input) -> Result<T> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        T value = move(result->first);
+        string_view remaining = result->second;
+        while (auto opResult = op(remaining)) {
+            auto operandResult = operand(opResult->second);
+            if (!operandResult) break;
+            value = combine(opResult->first, move(value), move(operandResult->first));
+            remaining = operandResult->second;
+        }
+        return make_pair(move(value), remaining);
+    };
+}
+
+
+// Character level rules: they return plain chars and spans and allocate nothing per call
+Parser<char> alnumParser = charSetParser(letters | digits);
+Parser<char> underscoreParser = charParser('_');
+Parser<string_view> identifierParser =
+    spanParser(seqParser(charSetParser(letters), skipManyParser(orParser(alnumParser, underscoreParser))));
+Parser<string_view> digitsParser = spanParser(seqParser(charSetParser(digits), skipManyParser(charSetParser(digits))));
+
+// Node level rules: only these construct AST nodes
+using Node = unique_ptr<ASTNode>;
+
+Parser<Node> variableParser = mapParser(identifierParser, [](string_view name) -> Node {
+    return make_unique<VariableNode>(string(name));
+});
+
+// A literal that does not fit an int fails the statement
+Parser<Node> numberParser = [](string_view input) -> Result<Node> {
+    auto digitsResult = digitsParser(input);
+    if (!digitsResult) return nullopt;
+    string_view text = digitsResult->first;
+    int value = 0;
+    if (from_chars(text.data(), text.data() + text.size(), value).ec != errc()) return nullopt;
+    return make_pair(make_unique<NumberNode>(value), digitsResult->second);
+};
+
+// Parser for a term (number or variable)
+Parser<Node> termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser<Node> expressionParser = chainLeftParser(termParser, lexeme(charParser('+')), [](char op, Node left, Node right) -> Node {
+    return make_unique<BinaryOpNode>(op, move(left), move(right));
+});
+
+// Parser for assignment (variable = expression)
+Parser<Node> assignmentParser = mapParser(
+    seqParser(lexeme(variableParser), skipParser(lexeme(charParser('='))), expressionParser),
+    [](tuple<Node, Unit, Node> parts) -> Node {
+        return make_unique<AssignmentNode>(move(get<0>(parts)), move(get<2>(parts)));
+    });
+
+// Parser for one statement: assignment ';'
+Parser<Node> statementParser = mapParser(
+    seqParser(assignmentParser, skipParser(lexeme(charParser(';')))),
+    [](tuple<Node, Unit> parts) -> Node {
+        return move(get<0>(parts));
+    });
+
+// Whitespace between statements
+Parser<Unit> spacesParser = skipManyParser(charSetParser(spaces));
+
+// Free a statement without recursing down a long left spine of BinaryOpNodes
+void destroyStatement(Node statement) {
+    auto* assignment = static_cast<AssignmentNode*>(statement.get());
+    Node node = move(assignment->right);
+    while (auto* binary = dynamic_cast<BinaryOpNode*>(node.get())) {
+        node = move(binary->left);
+    }
+}
+
+// Counters for one input file
+struct FileStats {
+    string path;
+    uint64_t bytes = 0;
+    uint64_t statements = 0;
+    uint64_t errors = 0;
+    double seconds = 0;
+    double cpuSeconds = 0;
+    bool readable = true;
+};
+
+// CPU time used by the calling thread, which unlike wall time is not
+// inflated when there are more threads than cores
+double threadCpuSeconds() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Parse a whole file. A statement that fails is counted and skipped up to the
+// next ';', so one bad line does not hide the rest of the file.
+void parseFile(FileStats& stats) {
+    auto start = chrono::steady_clock::now();
+    double cpuStart = threadCpuSeconds();
+    ifstream file(stats.path, ios::binary);
+    if (!file) {
+        stats.readable = false;
+        return;
+    }
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    stats.bytes = text.size();
+
+    string_view input = text;
+    while (true) {
+        input = spacesParser(input)->second;
+        if (input.empty()) break;
+        if (auto result = statementParser(input); result) {
+            destroyStatement(move(result->first));
+            stats.statements++;
+            input = result->second;
+        } else {
+            stats.errors++;
+            size_t end = input.find(';');
+            input = end == string_view::npos ? string_view() : input.substr(end + 1);
+        }
+    }
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.cpuSeconds = threadCpuSeconds() - cpuStart;
+}
+
+// Command line options
+struct Options {
+    vector<fs::path> inputs;
+    vector<string> extensions;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    bool quiet = false;
+};
+
+void usage(const char* program) {
+    cerr << "usage: " << program << " [-j threads] [-e extension]... [-l list_file]... [-q] path...\n"
+         << "  path          a file, or a directory that is searched recursively\n"
+         << "  -j threads    number of parser threads (default: one per core)\n"
+         << "  -e extension  only take files with this extension from directories, e.g. -e .txt\n"
+         << "  -l list_file  read more paths from a file, one per line; - reads standard input\n"
+         << "  -q            print only the totals\n";
+}
+
+// Read paths, one per line, from a list file
+bool readList(const string& name, vector<fs::path>& inputs) {
+    ifstream file;
+    if (name != "-") {
+        file.open(name);
+        if (!file) return false;
+    }
+    istream& in = name == "-" ? cin : file;
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) inputs.emplace_back(line);
+    }
+    return true;
+}
+
+optional<Options> parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-j" && hasValue) {
+            string_view value = argv[++i];
+            auto [end, error] = from_chars(value.data(), value.data() + value.size(), options.threads);
+            if (error != errc() || end != value.data() + value.size() || options.threads == 0) {
+                cerr << "bad thread count: " << value << endl;
+                return nullopt;
+            }
+        } else if (arg == "-e" && hasValue) {
+            string extension = argv[++i];
+            if (extension.empty() || extension == ".") {
+                cerr << "empty extension" << endl;
+                return nullopt;
+            }
+            options.extensions.push_back(extension.front() == '.' ? extension : "." + extension);
+        } else if (arg == "-l" && hasValue) {
+            if (!readList(argv[++i], options.inputs)) {
+                cerr << "cannot read list file " << argv[i] << endl;
+                return nullopt;
+            }
+        } else if (arg == "-q") {
+            options.quiet = true;
+        } else if (arg == "-h" || arg == "--help" || (arg.size() > 1 && arg[0] == '-')) {
+            return nullopt;
+        } else {
+            options.inputs.emplace_back(argv[i]);
+        }
+    }
+    if (options.inputs.empty()) return nullopt;
+    return options;
+}
+
+// Expand directories into the regular files below them, in a stable order.
+// A directory that cannot be walked to the end is reported and counted.
+vector<FileStats> collectFiles(const Options& options, size_t& walkErrors) {
+    vector<FileStats> files;
+    auto wanted = [&](const fs::path& path) {
+        return options.extensions.empty() ||
+               find(options.extensions.begin(), options.extensions.end(), path.extension().string()) != options.extensions.end();
+    };
+    for (const auto& input : options.inputs) {
+        error_code error;
+        if (fs::is_directory(input, error)) {
+            vector<string> found;
+            for (auto it = fs::recursive_directory_iterator(input, fs::directory_options::skip_permission_denied, error);
+                 !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+                if (it->is_regular_file(error) && wanted(it->path())) {
+                    found.push_back(it->path().string());
+                }
+            }
+            if (error) {
+                walkErrors++;
+                cerr << input.string() << ": cannot list directory: " << error.message() << endl;
+            }
+            sort(found.begin(), found.end());
+            for (auto& path : found) {
+                files.push_back(FileStats{move(path)});
+            }
+        } else {
+            // Named files are always taken; a missing one is reported as unreadable
+            files.push_back(FileStats{input.string()});
+        }
+    }
+    return files;
+}
+
+// Peak resident set size of the process so far, in bytes
+uint64_t peakResidentBytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // Linux reports KiB
+}
+
+double mebibytesPerSecond(uint64_t bytes, double seconds) {
+    return seconds > 0 ? bytes / seconds / (1 << 20) : 0;
+}
+
+int main(int argc, char* argv[]) {
+    optional<Options> options = parseOptions(argc, argv);
+    if (!options) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    size_t walkErrors = 0;
+    vector<FileStats> files = collectFiles(*options, walkErrors);
+    unsigned threads = static_cast<unsigned>(min<size_t>(options->threads, max<size_t>(files.size(), 1)));
+
+    // Workers take the next file from a shared counter, so large and small
+    // files balance out without any up front partitioning
+    auto start = chrono::steady_clock::now();
+    atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i; (i = next.fetch_add(1, memory_order_relaxed)) < files.size();) {
+            parseFile(files[i]);
+        }
+    };
+    vector<thread> pool;
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    FileStats total;
+    size_t unreadable = 0;
+    cout << fixed << setprecision(1);
+    for (const auto& file : files) {
+        if (!file.readable) {
+            unreadable++;
+            cerr << file.path << ": cannot read" << endl;
+            continue;
+        }
+        total.bytes += file.bytes;
+        total.statements += file.statements;
+        total.errors += file.errors;
+        total.seconds += file.seconds;
+        total.cpuSeconds += file.cpuSeconds;
+        if (!options->quiet) {
+            cout << file.path << ": " << file.bytes << " bytes, " << file.statements << " statements, " << file.errors
+                 << " errors, " << file.seconds * 1000 << " ms, " << mebibytesPerSecond(file.bytes, file.seconds)
+                 << " MiB/s" << endl;
+        }
+    }
+
+    cout << "Files: " << files.size() - unreadable << " parsed, " << unreadable << " unreadable, " << walkErrors
+         << " directory errors" << endl;
+    cout << "Total: " << total.bytes << " bytes, " << total.statements << " statements, " << total.errors << " errors" << endl;
+    // CPU time over wall time is how many cores the run kept busy on average
+    cout << "Time: " << wallSeconds * 1000 << " ms wall on " << threads << " threads, " << total.cpuSeconds * 1000
+         << " ms CPU, " << (wallSeconds > 0 ? total.cpuSeconds / wallSeconds : 0) << " cores busy on average" << endl;
+    cout << "Throughput: " << mebibytesPerSecond(total.bytes, wallSeconds) << " MiB/s" << endl;
+    cout << "Peak memory: " << peakResidentBytes() / 1024 << " KiB resident" << endl;
 
-int main() {
-    std::cout << "Hello, World!";
-    return 0;
+    return total.errors > 0 || unreadable > 0 || walkErrors > 0 ? 1 : 0;
 }
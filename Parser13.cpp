@@ -0,0 +1,271 @@
+// how can single character rules like charParser('+'), alnumParser and underscoreParser be declared at compile time so that an orParser of them is one bitmap lookup?
+
+
+#include <iostream>
+#include <string>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// Define a parser combinator function type
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string>>(const string&)>;
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+// Parser for one character out of a CharSet. It is a literal type, so a
+// constexpr rule is constant-initialized and needs no static initializer.
+struct CharRule {
+    CharSet set;
+
+    optional<pair<unique_ptr<ASTNode>, string>> operator()(const string& input) const {
+        if (!input.empty() && set.contains(static_cast<unsigned char>(input[0]))) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    }
+};
+
+// Parser combinator function to parse a single character
+constexpr CharRule charParser(char c) {
+    return CharRule{CharSet(c)};
+}
+
+// Parser combinator function to parse any character of a set
+constexpr CharRule charSetParser(CharSet set) {
+    return CharRule{set};
+}
+
+constexpr CharRule operator|(CharRule a, CharRule b) {
+    return CharRule{a.set | b.set};
+}
+
+// OR combinator for single character rules: the alternatives collapse into
+// the union of their sets, so matching is one bitmap lookup
+template<typename... Rules, enable_if_t<(is_same_v<Rules, CharRule> && ...), int> = 0>
+constexpr CharRule orParser(CharRule first, Rules... rest) {
+    return (first | ... | rest);
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser> parserList = {parsers...};
+    return [parserList](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Define parsers for variable names using alnum and underscore characters
+constexpr CharRule alnumParser = charSetParser(letters | digits);
+constexpr CharRule underscoreParser = charParser('_');
+constexpr CharRule identifierCharParser = orParser(alnumParser, underscoreParser);
+
+static_assert(identifierCharParser.set.contains('_') && identifierCharParser.set.contains('7'));
+static_assert(!identifierCharParser.set.contains('+') && !identifierCharParser.set.contains(' '));
+
+// Parser for variable names: a letter followed by identifier characters
+struct VariableRule {
+    CharSet first;
+    CharSet rest;
+
+    optional<pair<unique_ptr<ASTNode>, string>> operator()(const string& input) const {
+        if (input.empty() || !first.contains(static_cast<unsigned char>(input[0]))) {
+            return nullopt;
+        }
+
+        size_t pos = 1;
+        while (pos < input.size() && rest.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+
+        return make_pair(make_unique<VariableNode>(input.substr(0, pos)), input.substr(pos));
+    }
+};
+
+constexpr VariableRule variableParser{letters, identifierCharParser.set};
+
+// Parser for numbers (sequence of digits)
+struct NumberRule {
+    CharSet digits;
+
+    optional<pair<unique_ptr<ASTNode>, string>> operator()(const string& input) const {
+        size_t pos = 0;
+        while (pos < input.size() && digits.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        int value = 0;
+        if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+            return nullopt;
+        }
+        return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+    }
+};
+
+constexpr NumberRule numberParser{digits};
+
+// Parser for the '+' and '=' operators
+constexpr CharRule plusParser = charParser('+');
+constexpr CharRule equalsParser = charParser('=');
+
+// Parser for assignment (variable = number), allowing spaces around '='
+struct AssignmentRule {
+    VariableRule variable;
+    CharRule equals;
+    NumberRule number;
+    CharSet spaces;
+
+    optional<pair<unique_ptr<ASTNode>, string>> operator()(const string& input) const {
+        auto variableResult = variable(input);
+        if (!variableResult) return nullopt;
+
+        auto equalsResult = equals(skipSpaces(variableResult->second));
+        if (!equalsResult) return nullopt;
+
+        auto numberResult = number(skipSpaces(equalsResult->second));
+        if (!numberResult) return nullopt;
+
+        return make_pair(
+            make_unique<AssignmentNode>(move(variableResult->first), move(numberResult->first)),
+            numberResult->second
+        );
+    }
+
+    string skipSpaces(const string& input) const {
+        size_t pos = 0;
+        while (pos < input.size() && spaces.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return input.substr(pos);
+    }
+};
+
+constexpr AssignmentRule assignmentParser{variableParser, equalsParser, numberParser, spaces};
+
+// Test the parser
+int main() {
+    string input = "x = 42 + y_2";
+
+    // Combine parsers using the OR combinator; only this top-level choice is built at runtime
+    auto combinedParser = orParser(Parser(assignmentParser), Parser(variableParser), Parser(plusParser));
+
+    // Parse the input
+    size_t startPos = 0;
+    while (startPos < input.size()) {
+        if (auto result = combinedParser(input.substr(startPos)); result) {
+            unique_ptr<ASTNode> node = move(result->first);
+            string remaining = result->second;
+            if (node) {
+                cout << "Parsed: ";
+                node->print();
+                cout << endl;
+            } else {
+                cout << "Parsed: +" << endl; // Handle the plus operator
+            }
+            startPos = input.size() - remaining.size();
+        } else {
+            // Skip invalid characters
+            startPos++;
+        }
+    }
+
+    return 0;
+}
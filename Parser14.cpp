@@ -0,0 +1,297 @@
+// how can multi-character operators like == += <= and keywords be recognized with one longest-match parser instead of an orParser that tries every alternative?
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <cctype>
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+// Kinds of fixed tokens recognized by the token trie
+enum class TokenKind : uint8_t {
+    Operator,
+    Keyword
+};
+
+class TokenNode : public ASTNode {
+public:
+    TokenKind kind;
+    string text;
+    TokenNode(TokenKind kind, const string& text) : kind(kind), text(text) {}
+    void print() const override {
+        cout << (kind == TokenKind::Keyword ? "Keyword(" : "Operator(") << text << ")";
+    }
+};
+
+// Define a parser combinator function type
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string>>(const string&)>;
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// A fixed operator or keyword spelling
+struct TokenSpec {
+    string_view text;
+    TokenKind kind;
+};
+
+// The operators and keywords of the language. Adding entries here only grows
+// the trie; matching still scans the input once.
+constexpr TokenSpec tokenSpecs[] = {
+    {"=", TokenKind::Operator},   {"==", TokenKind::Operator},  {"!", TokenKind::Operator},
+    {"!=", TokenKind::Operator},  {"+", TokenKind::Operator},   {"+=", TokenKind::Operator},
+    {"++", TokenKind::Operator},  {"-", TokenKind::Operator},   {"-=", TokenKind::Operator},
+    {"--", TokenKind::Operator},  {"->", TokenKind::Operator},  {"*", TokenKind::Operator},
+    {"*=", TokenKind::Operator},  {"/", TokenKind::Operator},   {"/=", TokenKind::Operator},
+    {"%", TokenKind::Operator},   {"%=", TokenKind::Operator},  {"<", TokenKind::Operator},
+    {"<=", TokenKind::Operator},  {"<<", TokenKind::Operator},  {"<<=", TokenKind::Operator},
+    {">", TokenKind::Operator},   {">=", TokenKind::Operator},  {">>", TokenKind::Operator},
+    {">>=", TokenKind::Operator}, {"&", TokenKind::Operator},   {"&&", TokenKind::Operator},
+    {"&=", TokenKind::Operator},  {"|", TokenKind::Operator},   {"||", TokenKind::Operator},
+    {"|=", TokenKind::Operator},  {"^", TokenKind::Operator},   {"^=", TokenKind::Operator},
+    {"(", TokenKind::Operator},   {")", TokenKind::Operator},   {";", TokenKind::Operator},
+    {"::", TokenKind::Operator},
+    {"if", TokenKind::Keyword},   {"else", TokenKind::Keyword}, {"while", TokenKind::Keyword},
+    {"for", TokenKind::Keyword},  {"do", TokenKind::Keyword},   {"return", TokenKind::Keyword},
+    {"break", TokenKind::Keyword}, {"continue", TokenKind::Keyword}, {"int", TokenKind::Keyword},
+    {"auto", TokenKind::Keyword}, {"const", TokenKind::Keyword}, {"constexpr", TokenKind::Keyword},
+};
+
+// Upper bound on trie nodes: the root plus one node per spelled character
+template<size_t N>
+constexpr size_t maxTrieNodes(const TokenSpec (&specs)[N]) {
+    size_t nodes = 1;
+    for (const auto& spec : specs) {
+        nodes += spec.text.size();
+    }
+    return nodes;
+}
+
+// Result of a longest-match lookup; token is an index into the token specs
+struct TrieMatch {
+    int token = -1;
+    size_t length = 0;
+};
+
+// Dense ASCII trie generated at compile time. Each input byte is one table
+// lookup, so the cost of a match does not depend on how many tokens exist.
+template<size_t Nodes>
+struct TokenTrie {
+    array<array<uint16_t, 128>, Nodes> next{}; // 0 means no edge; the root is never a child
+    array<int16_t, Nodes> accept{};
+    size_t size = 1;
+
+    template<size_t N>
+    constexpr void build(const TokenSpec (&specs)[N]) {
+        for (auto& token : accept) {
+            token = -1;
+        }
+        for (size_t i = 0; i < N; i++) {
+            size_t node = 0;
+            for (char c : specs[i].text) {
+                auto& edge = next[node][static_cast<unsigned char>(c) & 127];
+                if (edge == 0) {
+                    edge = static_cast<uint16_t>(size++);
+                }
+                node = edge;
+            }
+            accept[node] = static_cast<int16_t>(i);
+        }
+    }
+
+    // Keywords only match on a word boundary, so "iffy" is not "if" followed by "fy"
+    template<size_t N>
+    constexpr TrieMatch longestMatch(string_view input, const TokenSpec (&specs)[N]) const {
+        TrieMatch match;
+        size_t node = 0;
+        for (size_t pos = 0; pos < input.size(); pos++) {
+            unsigned char c = static_cast<unsigned char>(input[pos]);
+            if (c >= 128 || next[node][c] == 0) {
+                break;
+            }
+            node = next[node][c];
+            if (int token = accept[node]; token >= 0) {
+                bool boundary = pos + 1 == input.size() ||
+                                !identifierChars.contains(static_cast<unsigned char>(input[pos + 1]));
+                if (specs[token].kind == TokenKind::Operator || boundary) {
+                    match = TrieMatch{token, pos + 1};
+                }
+            }
+        }
+        return match;
+    }
+};
+
+template<size_t Nodes, size_t N>
+constexpr TokenTrie<Nodes> buildTrie(const TokenSpec (&specs)[N]) {
+    TokenTrie<Nodes> trie;
+    trie.build(specs);
+    return trie;
+}
+
+constexpr auto tokenTrie = buildTrie<maxTrieNodes(tokenSpecs)>(tokenSpecs);
+
+static_assert(tokenTrie.longestMatch("<<= 1", tokenSpecs).length == 3);
+static_assert(tokenTrie.longestMatch("+x", tokenSpecs).length == 1);
+static_assert(tokenTrie.longestMatch("iffy", tokenSpecs).token == -1);
+
+// Longest-match parser for all operators and keywords in the trie
+template<size_t Nodes, size_t N>
+Parser tokenParser(const TokenTrie<Nodes>& trie, const TokenSpec (&specs)[N]) {
+    return [&trie, &specs](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        TrieMatch match = trie.longestMatch(input, specs);
+        if (match.token < 0) {
+            return nullopt;
+        }
+        const TokenSpec& spec = specs[match.token];
+        return make_pair(make_unique<TokenNode>(spec.kind, string(spec.text)), input.substr(match.length));
+    };
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser> parserList = {parsers...};
+    return [parserList](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Parser for variable names
+Parser variableParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    if (input.empty() || !letters.contains(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+
+    size_t pos = 1;
+    while (pos < input.size() && identifierChars.contains(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+
+    return make_pair(make_unique<VariableNode>(input.substr(0, pos)), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits)
+Parser numberParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    size_t pos = 0;
+    while (pos < input.size() && digits.contains(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    int value = 0;
+    if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+        return nullopt;
+    }
+    return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+};
+
+// Operators and keywords come first so that "if" is not read as a variable
+auto combinedParser = orParser(tokenParser(tokenTrie, tokenSpecs), variableParser, numberParser);
+
+// Test the parser
+int main() {
+    string input = "x += 42; if (x >= y_2) iffy = x == 1 << 3; y_2 <<= 1";
+
+    // Parse the input
+    size_t startPos = 0;
+    while (startPos < input.size()) {
+        if (spaces.contains(static_cast<unsigned char>(input[startPos]))) {
+            startPos++;
+        } else if (auto result = combinedParser(input.substr(startPos)); result) {
+            unique_ptr<ASTNode> node = move(result->first);
+            string remaining = result->second;
+            cout << "Parsed: ";
+            node->print();
+            cout << endl;
+            startPos = input.size() - remaining.size();
+        } else {
+            // Skip invalid characters
+            startPos++;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+// how can a left recursive rule like expr := expr '+' term be parsed so that a + b + c + ... builds a left associative BinaryOpNode tree without growing the stack?
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <cctype>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// Define a parser combinator function type. The remainder is a view into
+// the caller's input, so stepping over a token never copies the rest.
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string_view>>(string_view)>;
+
+// Parser combinator function to parse a single character
+Parser charParser(char c) {
+    return [c](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser> parserList = {parsers...};
+    return [parserList](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+Parser lexeme(Parser parser) {
+    return [parser](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+        size_t pos = 0;
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return parser(pos == 0 ? input : input.substr(pos));
+    };
+}
+
+// Chain combinator for left recursive rules of the form
+//     rule := rule op operand | operand
+// Instead of recursing, it parses one operand and then loops over
+// (op operand) pairs, folding each into a new BinaryOpNode whose left child
+// is the tree built so far. The stack depth is constant in the chain length.
+Parser chainLeftParser(Parser operand, const string& operators) {
+    vector<pair<char, Parser>> operatorParsers;
+    for (char op : operators) {
+        operatorParsers.emplace_back(op, lexeme(charParser(op)));
+    }
+
+    return [operand, operatorParsers](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        unique_ptr<ASTNode> tree = move(result->first);
+        string_view remaining = result->second;
+
+        while (true) {
+            optional<pair<unique_ptr<ASTNode>, string_view>> operatorResult;
+            char op = 0;
+            for (const auto& [symbol, parser] : operatorParsers) {
+                if ((operatorResult = parser(remaining))) {
+                    op = symbol;
+                    break;
+                }
+            }
+            if (!operatorResult) break;
+
+            // A trailing operator without an operand is left unconsumed
+            auto operandResult = operand(operatorResult->second);
+            if (!operandResult) break;
+
+            tree = make_unique<BinaryOpNode>(op, move(tree), move(operandResult->first));
+            remaining = operandResult->second;
+        }
+
+        return make_pair(move(tree), remaining);
+    };
+}
+
+// Parser for variable names
+Parser variableParser = [](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+    if (input.empty() || !isalpha(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+
+    size_t pos = 1;
+    while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+        pos++;
+    }
+
+    return make_pair(make_unique<VariableNode>(string(input.substr(0, pos))), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits)
+Parser numberParser = [](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+    size_t pos = 0;
+    while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    int value = 0;
+    if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+        return nullopt;
+    }
+    return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+};
+
+// Parser for a term (number or variable)
+Parser termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser expressionParser = chainLeftParser(termParser, "+");
+
+// Parser for the '=' operator
+Parser equalsParser = lexeme(charParser('='));
+
+// Parser for assignment (variable = expression)
+Parser assignmentParser = [](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+    auto variableResult = lexeme(variableParser)(input);
+    if (!variableResult) return nullopt;
+
+    auto equalsResult = equalsParser(variableResult->second);
+    if (!equalsResult) return nullopt;
+
+    auto expressionResult = expressionParser(equalsResult->second);
+    if (!expressionResult) return nullopt;
+
+    return make_pair(
+        make_unique<AssignmentNode>(move(variableResult->first), move(expressionResult->first)),
+        expressionResult->second
+    );
+};
+
+// Test the parser
+int main(int argc, char* argv[]) {
+    string input = "x = 42 + y_2 + 7";
+
+    if (auto result = assignmentParser(input); result) {
+        cout << "Parsed: ";
+        result->first->print();
+        cout << endl;
+    }
+
+    // A long chain a0 + a1 + ... is folded in a loop, so parsing it needs no deep recursion
+    size_t terms = argc > 1 ? stoul(argv[1]) : 10000;
+    string chain = "total = a0";
+    for (size_t i = 1; i < terms; i++) {
+        chain += " + a" + to_string(i);
+    }
+
+    if (auto result = assignmentParser(chain); result) {
+        // Walk the left spine to show the tree is left associative
+        size_t depth = 0;
+        const ASTNode* node = static_cast<AssignmentNode*>(result->first.get())->right.get();
+        while (auto binary = dynamic_cast<const BinaryOpNode*>(node)) {
+            node = binary->left.get();
+            depth++;
+        }
+        cout << "Parsed chain of " << terms << " terms, left spine depth " << depth << ", first operand ";
+        node->print();
+        cout << endl;
+    }
+
+    return 0;
+}
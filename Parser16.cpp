@@ -0,0 +1,361 @@
+// printing or destroying a BinaryOpNode tree with a million nested nodes recurses a million deep and crashes; make teardown and print() iterative and buffer the output
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Buffered output sink: fragments are collected in memory and written to the
+// stream in large blocks instead of one stream insertion per fragment
+class OutputBuffer {
+public:
+    explicit OutputBuffer(ostream& out, size_t capacity = 1 << 16) : out(out), capacity(capacity) {
+        buffer.reserve(capacity);
+    }
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    ~OutputBuffer() {
+        flush();
+    }
+
+    void write(string_view text) {
+        if (buffer.size() + text.size() > capacity) {
+            flush();
+        }
+        buffer.append(text);
+    }
+
+    void write(char c) {
+        write(string_view(&c, 1));
+    }
+
+    void write(int value) {
+        char digits[16];
+        auto end = to_chars(digits, digits + sizeof(digits), value).ptr;
+        write(string_view(digits, end - digits));
+    }
+
+    void write(uint64_t value) {
+        char digits[24];
+        auto end = to_chars(digits, digits + sizeof(digits), value).ptr;
+        write(string_view(digits, end - digits));
+    }
+
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+private:
+    ostream& out;
+    size_t capacity;
+    string buffer;
+};
+
+class ASTNode;
+
+// Pending step of an iterative print: a node still to be printed, or literal text
+struct PrintStep {
+    const ASTNode* node;
+    string_view text;
+};
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+
+    // Write this node's leading text and push the rest of its output, in
+    // reverse order, onto the explicit print stack
+    virtual void expand(OutputBuffer& out, vector<PrintStep>& steps) const = 0;
+
+    // Move the owned children onto the explicit destruction stack
+    virtual void releaseChildren(vector<unique_ptr<ASTNode>>&) {}
+
+    // Print the tree using an explicit stack instead of recursion
+    void print(OutputBuffer& out) const {
+        vector<PrintStep> steps{{this, {}}};
+        while (!steps.empty()) {
+            PrintStep step = steps.back();
+            steps.pop_back();
+            if (step.node) {
+                step.node->expand(out, steps);
+            } else {
+                out.write(step.text);
+            }
+        }
+    }
+
+    void print() const {
+        OutputBuffer out(cout);
+        print(out);
+    }
+};
+
+// Destroy the children of a node without recursion: every node taken off the
+// stack hands its own children to the stack before it is deleted, so no
+// destructor ever runs with a child still attached
+void destroyChildren(ASTNode& node) {
+    vector<unique_ptr<ASTNode>> pending;
+    node.releaseChildren(pending);
+    while (!pending.empty()) {
+        unique_ptr<ASTNode> current = move(pending.back());
+        pending.pop_back();
+        current->releaseChildren(pending);
+    }
+}
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void expand(OutputBuffer& out, vector<PrintStep>&) const override {
+        out.write("Variable(");
+        out.write(name);
+        out.write(')');
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void expand(OutputBuffer& out, vector<PrintStep>&) const override {
+        out.write("Number(");
+        out.write(value);
+        out.write(')');
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    ~BinaryOpNode() override {
+        destroyChildren(*this);
+    }
+    void expand(OutputBuffer& out, vector<PrintStep>& steps) const override {
+        out.write("BinaryOp(");
+        out.write(op);
+        out.write(", ");
+        steps.push_back({nullptr, ")"});
+        steps.push_back({right.get(), {}});
+        steps.push_back({nullptr, ", "});
+        steps.push_back({left.get(), {}});
+    }
+    void releaseChildren(vector<unique_ptr<ASTNode>>& nodes) override {
+        if (left) nodes.push_back(move(left));
+        if (right) nodes.push_back(move(right));
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    ~AssignmentNode() override {
+        destroyChildren(*this);
+    }
+    void expand(OutputBuffer& out, vector<PrintStep>& steps) const override {
+        out.write("Assignment(");
+        steps.push_back({nullptr, ")"});
+        steps.push_back({right.get(), {}});
+        steps.push_back({nullptr, " = "});
+        steps.push_back({left.get(), {}});
+    }
+    void releaseChildren(vector<unique_ptr<ASTNode>>& nodes) override {
+        if (left) nodes.push_back(move(left));
+        if (right) nodes.push_back(move(right));
+    }
+};
+
+// Define a parser combinator function type. The remainder is a view into
+// the caller's input, so stepping over a token never copies the rest.
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string_view>>(string_view)>;
+
+// Parser combinator function to parse a single character
+Parser charParser(char c) {
+    return [c](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser> parserList = {parsers...};
+    return [parserList](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+Parser lexeme(Parser parser) {
+    return [parser](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+        size_t pos = 0;
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return parser(pos == 0 ? input : input.substr(pos));
+    };
+}
+
+// Chain combinator for left recursive rules of the form
+//     rule := rule op operand | operand
+// Instead of recursing, it parses one operand and then loops over
+// (op operand) pairs, folding each into a new BinaryOpNode whose left child
+// is the tree built so far. The stack depth is constant in the chain length.
+Parser chainLeftParser(Parser operand, const string& operators) {
+    vector<pair<char, Parser>> operatorParsers;
+    for (char op : operators) {
+        operatorParsers.emplace_back(op, lexeme(charParser(op)));
+    }
+
+    return [operand, operatorParsers](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        unique_ptr<ASTNode> tree = move(result->first);
+        string_view remaining = result->second;
+
+        while (true) {
+            optional<pair<unique_ptr<ASTNode>, string_view>> operatorResult;
+            char op = 0;
+            for (const auto& [symbol, parser] : operatorParsers) {
+                if ((operatorResult = parser(remaining))) {
+                    op = symbol;
+                    break;
+                }
+            }
+            if (!operatorResult) break;
+
+            // A trailing operator without an operand is left unconsumed
+            auto operandResult = operand(operatorResult->second);
+            if (!operandResult) break;
+
+            tree = make_unique<BinaryOpNode>(op, move(tree), move(operandResult->first));
+            remaining = operandResult->second;
+        }
+
+        return make_pair(move(tree), remaining);
+    };
+}
+
+// Parser for variable names
+Parser variableParser = [](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+    if (input.empty() || !isalpha(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+
+    size_t pos = 1;
+    while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+        pos++;
+    }
+
+    return make_pair(make_unique<VariableNode>(string(input.substr(0, pos))), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits)
+Parser numberParser = [](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+    size_t pos = 0;
+    while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    int value = 0;
+    if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+        return nullopt;
+    }
+    return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+};
+
+// Parser for a term (number or variable)
+Parser termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser expressionParser = chainLeftParser(termParser, "+");
+
+// Parser for the '=' operator
+Parser equalsParser = lexeme(charParser('='));
+
+// Parser for assignment (variable = expression)
+Parser assignmentParser = [](string_view input) -> optional<pair<unique_ptr<ASTNode>, string_view>> {
+    auto variableResult = lexeme(variableParser)(input);
+    if (!variableResult) return nullopt;
+
+    auto equalsResult = equalsParser(variableResult->second);
+    if (!equalsResult) return nullopt;
+
+    auto expressionResult = expressionParser(equalsResult->second);
+    if (!expressionResult) return nullopt;
+
+    return make_pair(
+        make_unique<AssignmentNode>(move(variableResult->first), move(expressionResult->first)),
+        expressionResult->second
+    );
+};
+
+// Test the parser
+int main(int argc, char* argv[]) {
+    OutputBuffer out(cout);
+
+    for (string input : {"x = 42 + y_2 + 7", "total = a + b + c"}) {
+        if (auto result = assignmentParser(input); result) {
+            out.write("Parsed: ");
+            result->first->print(out);
+            out.write('\n');
+        }
+    }
+
+    // Build a tree nested a million levels deep, alternating left and right
+    // nesting, then print and destroy it without deep recursion
+    size_t depth = argc > 1 ? stoul(argv[1]) : 1000000;
+    unique_ptr<ASTNode> tree = make_unique<NumberNode>(0);
+    for (size_t i = 1; i < depth; i++) {
+        auto leaf = make_unique<VariableNode>("v");
+        if (i % 2) {
+            tree = make_unique<BinaryOpNode>('+', move(tree), move(leaf));
+        } else {
+            tree = make_unique<BinaryOpNode>('+', move(leaf), move(tree));
+        }
+    }
+
+    ostringstream text;
+    {
+        OutputBuffer textOut(text);
+        tree->print(textOut);
+    }
+    tree.reset();
+
+    out.write("Printed and destroyed a tree nested ");
+    out.write(uint64_t(depth));
+    out.write(" levels deep (");
+    out.write(uint64_t(text.str().size()));
+    out.write(" bytes of output)\n");
+
+    return 0;
+}
@@ -0,0 +1,738 @@
+// parsed results are cached between runs; add a compact versioned binary AST format that can be loaded zero-copy with mmap, and a fast JSON emitter
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Buffered output sink: fragments are collected in memory and written to the
+// stream in large blocks instead of one stream insertion per fragment
+class OutputBuffer {
+public:
+    explicit OutputBuffer(ostream& out, size_t capacity = 1 << 16) : out(out), capacity(capacity) {
+        buffer.reserve(capacity);
+    }
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    ~OutputBuffer() {
+        flush();
+    }
+
+    void write(string_view text) {
+        if (buffer.size() + text.size() > capacity) {
+            flush();
+        }
+        buffer.append(text);
+    }
+
+    void write(char c) {
+        write(string_view(&c, 1));
+    }
+
+    void write(int value) {
+        char digits[16];
+        auto end = to_chars(digits, digits + sizeof(digits), value).ptr;
+        write(string_view(digits, end - digits));
+    }
+
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+private:
+    ostream& out;
+    size_t capacity;
+    string buffer;
+};
+
+class ASTNode;
+
+// Node kinds, also used as the tag of each record in the binary format
+enum class NodeKind : uint8_t {
+    Variable = 1,
+    Number = 2,
+    BinaryOp = 3,
+    Assignment = 4
+};
+
+// Pending step of an iterative print: a node still to be printed, or literal text
+struct PrintStep {
+    const ASTNode* node;
+    string_view text;
+};
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual NodeKind kind() const = 0;
+
+    // Write this node's leading text and push the rest of its output, in
+    // reverse order, onto the explicit print stack
+    virtual void expand(OutputBuffer& out, vector<PrintStep>& steps) const = 0;
+
+    // Move the owned children onto the explicit destruction stack
+    virtual void releaseChildren(vector<unique_ptr<ASTNode>>&) {}
+
+    // Print the tree using an explicit stack instead of recursion
+    void print(OutputBuffer& out) const {
+        vector<PrintStep> steps{{this, {}}};
+        while (!steps.empty()) {
+            PrintStep step = steps.back();
+            steps.pop_back();
+            if (step.node) {
+                step.node->expand(out, steps);
+            } else {
+                out.write(step.text);
+            }
+        }
+    }
+
+    void print() const {
+        OutputBuffer out(cout);
+        print(out);
+    }
+};
+
+// Destroy the children of a node without recursion: every node taken off the
+// stack hands its own children to the stack before it is deleted, so no
+// destructor ever runs with a child still attached
+void destroyChildren(ASTNode& node) {
+    vector<unique_ptr<ASTNode>> pending;
+    node.releaseChildren(pending);
+    while (!pending.empty()) {
+        unique_ptr<ASTNode> current = move(pending.back());
+        pending.pop_back();
+        current->releaseChildren(pending);
+    }
+}
+
+class VariableNode : public ASTNode {
+public:
+    NodeKind kind() const override { return NodeKind::Variable; }
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void expand(OutputBuffer& out, vector<PrintStep>&) const override {
+        out.write("Variable(");
+        out.write(name);
+        out.write(')');
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    NodeKind kind() const override { return NodeKind::Number; }
+    int value;
+    NumberNode(int value) : value(value) {}
+    void expand(OutputBuffer& out, vector<PrintStep>&) const override {
+        out.write("Number(");
+        out.write(value);
+        out.write(')');
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    NodeKind kind() const override { return NodeKind::BinaryOp; }
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    ~BinaryOpNode() override {
+        destroyChildren(*this);
+    }
+    void expand(OutputBuffer& out, vector<PrintStep>& steps) const override {
+        out.write("BinaryOp(");
+        out.write(op);
+        out.write(", ");
+        steps.push_back({nullptr, ")"});
+        steps.push_back({right.get(), {}});
+        steps.push_back({nullptr, ", "});
+        steps.push_back({left.get(), {}});
+    }
+    void releaseChildren(vector<unique_ptr<ASTNode>>& nodes) override {
+        if (left) nodes.push_back(move(left));
+        if (right) nodes.push_back(move(right));
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    NodeKind kind() const override { return NodeKind::Assignment; }
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    ~AssignmentNode() override {
+        destroyChildren(*this);
+    }
+    void expand(OutputBuffer& out, vector<PrintStep>& steps) const override {
+        out.write("Assignment(");
+        steps.push_back({nullptr, ")"});
+        steps.push_back({right.get(), {}});
+        steps.push_back({nullptr, " = "});
+        steps.push_back({left.get(), {}});
+    }
+    void releaseChildren(vector<unique_ptr<ASTNode>>& nodes) override {
+        if (left) nodes.push_back(move(left));
+        if (right) nodes.push_back(move(right));
+    }
+};
+
+// Define a parser combinator function type
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string>>(const string&)>;
+
+// Parser combinator function to parse a single character
+Parser charParser(char c) {
+    return [c](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser> parserList = {parsers...};
+    return [parserList](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+Parser lexeme(Parser parser) {
+    return [parser](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        size_t pos = 0;
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return parser(pos == 0 ? input : input.substr(pos));
+    };
+}
+
+// Chain combinator for left recursive rules of the form
+//     rule := rule op operand | operand
+// Instead of recursing, it parses one operand and then loops over
+// (op operand) pairs, folding each into a new BinaryOpNode whose left child
+// is the tree built so far. The stack depth is constant in the chain length.
+Parser chainLeftParser(Parser operand, const string& operators) {
+    vector<pair<char, Parser>> operatorParsers;
+    for (char op : operators) {
+        operatorParsers.emplace_back(op, lexeme(charParser(op)));
+    }
+
+    return [operand, operatorParsers](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        unique_ptr<ASTNode> tree = move(result->first);
+        string remaining = move(result->second);
+
+        while (true) {
+            optional<pair<unique_ptr<ASTNode>, string>> operatorResult;
+            char op = 0;
+            for (const auto& [symbol, parser] : operatorParsers) {
+                if ((operatorResult = parser(remaining))) {
+                    op = symbol;
+                    break;
+                }
+            }
+            if (!operatorResult) break;
+
+            // A trailing operator without an operand is left unconsumed
+            auto operandResult = operand(operatorResult->second);
+            if (!operandResult) break;
+
+            tree = make_unique<BinaryOpNode>(op, move(tree), move(operandResult->first));
+            remaining = move(operandResult->second);
+        }
+
+        return make_pair(move(tree), move(remaining));
+    };
+}
+
+// Parser for variable names
+Parser variableParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    if (input.empty() || !isalpha(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+
+    size_t pos = 1;
+    while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+        pos++;
+    }
+
+    return make_pair(make_unique<VariableNode>(input.substr(0, pos)), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits)
+Parser numberParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    size_t pos = 0;
+    while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    int value = 0;
+    if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+        return nullopt;
+    }
+    return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+};
+
+// Parser for a term (number or variable)
+Parser termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser expressionParser = chainLeftParser(termParser, "+");
+
+// Parser for the '=' operator
+Parser equalsParser = lexeme(charParser('='));
+
+// Parser for assignment (variable = expression)
+Parser assignmentParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    auto variableResult = lexeme(variableParser)(input);
+    if (!variableResult) return nullopt;
+
+    auto equalsResult = equalsParser(variableResult->second);
+    if (!equalsResult) return nullopt;
+
+    auto expressionResult = expressionParser(equalsResult->second);
+    if (!expressionResult) return nullopt;
+
+    return make_pair(
+        make_unique<AssignmentNode>(move(variableResult->first), move(expressionResult->first)),
+        expressionResult->second
+    );
+};
+
+// Binary AST format, version 1. All integers are little endian and all
+// references are indices, so a file can be used straight from an mmap.
+//
+//   header   magic "CPPAST\0\0", version, node count, root count, string bytes (u32 each)
+//   nodes    node count records of 12 bytes: kind (u8), op (u8), 2 reserved bytes, a (u32), b (u32)
+//   roots    root count node indices (u32)
+//   strings  variable names, referenced by (offset, length) from Variable records
+//
+// Record fields by kind: Variable a = name offset, b = name length; Number
+// a = value; BinaryOp and Assignment a = left index, b = right index. Nodes
+// are stored in post order, so every child index is smaller than its parent.
+constexpr char astMagic[8] = {'C', 'P', 'P', 'A', 'S', 'T', 0, 0};
+constexpr uint32_t astVersion = 1;
+constexpr size_t astHeaderSize = 24;
+constexpr size_t astRecordSize = 12;
+
+void put32(string& out, uint32_t value) {
+    char bytes[4] = {char(value), char(value >> 8), char(value >> 16), char(value >> 24)};
+    out.append(bytes, 4);
+}
+
+uint32_t get32(const char* data) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    return uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 | uint32_t(bytes[2]) << 16 | uint32_t(bytes[3]) << 24;
+}
+
+// Decoded node record
+struct NodeRecord {
+    NodeKind kind;
+    char op;
+    uint32_t a;
+    uint32_t b;
+};
+
+// Serializer: trees are added one at a time and flattened iteratively
+class AstWriter {
+public:
+    // Append a tree and return the index of its root record
+    uint32_t add(const ASTNode& root) {
+        vector<pair<const ASTNode*, bool>> stack{{&root, false}};
+        vector<uint32_t> finished;
+        while (!stack.empty()) {
+            auto [node, childrenDone] = stack.back();
+            stack.pop_back();
+            const ASTNode* left = nullptr;
+            const ASTNode* right = nullptr;
+            if (auto binary = dynamic_cast<const BinaryOpNode*>(node)) {
+                left = binary->left.get();
+                right = binary->right.get();
+            } else if (auto assignment = dynamic_cast<const AssignmentNode*>(node)) {
+                left = assignment->left.get();
+                right = assignment->right.get();
+            }
+
+            if (left && !childrenDone) {
+                stack.push_back({node, true});
+                stack.push_back({right, false});
+                stack.push_back({left, false});
+                continue;
+            }
+
+            NodeRecord record{node->kind(), 0, 0, 0};
+            if (left) {
+                record.b = finished.back();
+                finished.pop_back();
+                record.a = finished.back();
+                finished.pop_back();
+                if (auto binary = dynamic_cast<const BinaryOpNode*>(node)) {
+                    record.op = binary->op;
+                }
+            } else if (auto variable = dynamic_cast<const VariableNode*>(node)) {
+                record.a = internName(variable->name);
+                record.b = static_cast<uint32_t>(variable->name.size());
+            } else if (auto number = dynamic_cast<const NumberNode*>(node)) {
+                record.a = static_cast<uint32_t>(number->value);
+            }
+            finished.push_back(static_cast<uint32_t>(records.size()));
+            records.push_back(record);
+        }
+        roots.push_back(finished.back());
+        return finished.back();
+    }
+
+    string finish() const {
+        string out;
+        out.reserve(astHeaderSize + records.size() * astRecordSize + roots.size() * 4 + strings.size());
+        out.append(astMagic, sizeof(astMagic));
+        put32(out, astVersion);
+        put32(out, static_cast<uint32_t>(records.size()));
+        put32(out, static_cast<uint32_t>(roots.size()));
+        put32(out, static_cast<uint32_t>(strings.size()));
+        for (const auto& record : records) {
+            out.push_back(static_cast<char>(record.kind));
+            out.push_back(record.op);
+            out.append(2, '\0');
+            put32(out, record.a);
+            put32(out, record.b);
+        }
+        for (uint32_t root : roots) {
+            put32(out, root);
+        }
+        out.append(strings);
+        return out;
+    }
+
+private:
+    // Repeated names are stored once in the string pool
+    uint32_t internName(const string& name) {
+        auto [it, inserted] = nameOffsets.try_emplace(name, static_cast<uint32_t>(strings.size()));
+        if (inserted) {
+            strings.append(name);
+        }
+        return it->second;
+    }
+
+    vector<NodeRecord> records;
+    vector<uint32_t> roots;
+    string strings;
+    unordered_map<string, uint32_t> nameOffsets;
+};
+
+// Zero-copy reader over a serialized AST. Nothing is decoded up front, but
+// open validates every record once: kinds, name ranges within the string
+// pool, children that precede their parent and have exactly one parent, and
+// roots that are in range and nobody's child. A truncated or corrupted cache
+// file is rejected there, so the accessors and walks need no checks.
+class AstView {
+public:
+    static optional<AstView> open(string_view bytes) {
+        if (bytes.size() < astHeaderSize || memcmp(bytes.data(), astMagic, sizeof(astMagic)) != 0) {
+            return nullopt;
+        }
+        if (get32(bytes.data() + 8) != astVersion) {
+            return nullopt;
+        }
+        AstView view;
+        view.data = bytes.data();
+        view.nodes = get32(bytes.data() + 12);
+        view.rootTotal = get32(bytes.data() + 16);
+        view.stringBytes = get32(bytes.data() + 20);
+        uint64_t expected = astHeaderSize + uint64_t(view.nodes) * astRecordSize + uint64_t(view.rootTotal) * 4 + view.stringBytes;
+        if (expected != bytes.size() || !view.validate()) {
+            return nullopt;
+        }
+        return view;
+    }
+
+    uint32_t nodeCount() const { return nodes; }
+    uint32_t rootCount() const { return rootTotal; }
+
+    uint32_t root(uint32_t i) const {
+        return get32(data + astHeaderSize + size_t(nodes) * astRecordSize + size_t(i) * 4);
+    }
+
+    NodeRecord node(uint32_t i) const {
+        const char* record = data + astHeaderSize + size_t(i) * astRecordSize;
+        return NodeRecord{static_cast<NodeKind>(record[0]), record[1], get32(record + 4), get32(record + 8)};
+    }
+
+    string_view name(const NodeRecord& record) const {
+        const char* pool = data + astHeaderSize + size_t(nodes) * astRecordSize + size_t(rootTotal) * 4;
+        return string_view(pool + record.a, record.b);
+    }
+
+    // Rebuild owning trees for all roots. Because children precede their
+    // parents, one forward pass suffices and no recursion is needed. open has
+    // validated every record, so this cannot fail.
+    vector<unique_ptr<ASTNode>> materialize() const {
+        vector<unique_ptr<ASTNode>> built(nodes);
+        for (uint32_t i = 0; i < nodes; i++) {
+            NodeRecord record = node(i);
+            switch (record.kind) {
+            case NodeKind::Variable:
+                built[i] = make_unique<VariableNode>(string(name(record)));
+                break;
+            case NodeKind::Number:
+                built[i] = make_unique<NumberNode>(static_cast<int>(record.a));
+                break;
+            case NodeKind::BinaryOp:
+            case NodeKind::Assignment:
+                if (record.kind == NodeKind::BinaryOp) {
+                    built[i] = make_unique<BinaryOpNode>(record.op, move(built[record.a]), move(built[record.b]));
+                } else {
+                    built[i] = make_unique<AssignmentNode>(move(built[record.a]), move(built[record.b]));
+                }
+                break;
+            }
+        }
+
+        vector<unique_ptr<ASTNode>> trees;
+        for (uint32_t i = 0; i < rootTotal; i++) {
+            trees.push_back(move(built[root(i)]));
+        }
+        return trees;
+    }
+
+private:
+    AstView() = default;
+
+    // One forward pass over the records. Children must come before their
+    // parent, which rules out cycles, and be adopted only once, which rules
+    // out shared subtrees; together every root is the top of a finite tree.
+    bool validate() const {
+        vector<bool> adopted(nodes);
+        auto adopt = [&](uint32_t child, uint32_t parent) {
+            if (child >= parent || adopted[child]) return false;
+            adopted[child] = true;
+            return true;
+        };
+        for (uint32_t i = 0; i < nodes; i++) {
+            NodeRecord record = node(i);
+            switch (record.kind) {
+            case NodeKind::Variable:
+                if (uint64_t(record.a) + record.b > stringBytes) return false;
+                break;
+            case NodeKind::Number:
+                break;
+            case NodeKind::BinaryOp:
+            case NodeKind::Assignment:
+                if (!adopt(record.a, i) || !adopt(record.b, i)) return false;
+                break;
+            default:
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < rootTotal; i++) {
+            uint32_t index = root(i);
+            if (index >= nodes || adopted[index]) return false;
+            adopted[index] = true;
+        }
+        return true;
+    }
+
+    const char* data = nullptr;
+    uint32_t nodes = 0;
+    uint32_t rootTotal = 0;
+    uint32_t stringBytes = 0;
+};
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const char*>(mapping);
+                size = info.st_size;
+            }
+        }
+        close(fd);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+        if (data) munmap(const_cast<char*>(data), size);
+    }
+
+    string_view bytes() const { return string_view(data, size); }
+    explicit operator bool() const { return data != nullptr; }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+// Write a JSON string literal
+void writeJsonString(OutputBuffer& out, string_view text) {
+    out.write('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out.write('\\');
+            out.write(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out.write(string_view(escaped, 6));
+        } else {
+            out.write(c);
+        }
+    }
+    out.write('"');
+}
+
+// Emit one serialized tree as JSON, straight from the view and without recursion
+void writeJson(const AstView& view, uint32_t root, OutputBuffer& out) {
+    constexpr uint32_t textStep = UINT32_MAX;
+    vector<pair<uint32_t, string_view>> steps{{root, {}}};
+    while (!steps.empty()) {
+        auto [index, text] = steps.back();
+        steps.pop_back();
+        if (index == textStep) {
+            out.write(text);
+            continue;
+        }
+
+        NodeRecord record = view.node(index);
+        switch (record.kind) {
+        case NodeKind::Variable:
+            out.write("{\"type\":\"Variable\",\"name\":");
+            writeJsonString(out, view.name(record));
+            out.write('}');
+            break;
+        case NodeKind::Number:
+            out.write("{\"type\":\"Number\",\"value\":");
+            out.write(static_cast<int>(record.a));
+            out.write('}');
+            break;
+        case NodeKind::BinaryOp:
+            out.write("{\"type\":\"BinaryOp\",\"op\":");
+            writeJsonString(out, string_view(&record.op, 1));
+            out.write(",\"left\":");
+            steps.push_back({textStep, "}"});
+            steps.push_back({record.b, {}});
+            steps.push_back({textStep, ",\"right\":"});
+            steps.push_back({record.a, {}});
+            break;
+        case NodeKind::Assignment:
+            out.write("{\"type\":\"Assignment\",\"target\":");
+            steps.push_back({textStep, "}"});
+            steps.push_back({record.b, {}});
+            steps.push_back({textStep, ",\"value\":"});
+            steps.push_back({record.a, {}});
+            break;
+        }
+    }
+}
+
+// Test the parser
+int main(int argc, char* argv[]) {
+    OutputBuffer out(cout);
+    string path = argc > 1 ? argv[1] : (filesystem::temp_directory_path() / "parser17.ast").string();
+
+    // Parse a few statements and cache them in the binary format
+    AstWriter writer;
+    for (string input : {"x = 42 + y_2", "total = x + x + 7", "y_2 = 1"}) {
+        if (auto result = assignmentParser(input); result) {
+            writer.add(*result->first);
+        }
+    }
+    string cached = writer.finish();
+    ofstream(path, ios::binary) << cached;
+
+    // A child id pointing at its own record would loop a walk; open rejects it
+    string corrupted = cached;
+    memcpy(&corrupted[astHeaderSize + 3 * astRecordSize + 4], "\x03\0\0\0", 4);
+    out.write(AstView::open(corrupted) ? "Corrupted cache accepted\n" : "Corrupted cache rejected\n");
+
+    // Reload through a memory mapping and emit JSON without building nodes
+    {
+        MappedFile file(path);
+        auto view = file ? AstView::open(file.bytes()) : nullopt;
+        if (!view) {
+            cerr << "Cannot load " << path << endl;
+            return 1;
+        }
+        for (uint32_t i = 0; i < view->rootCount(); i++) {
+            writeJson(*view, view->root(i), out);
+            out.write('\n');
+        }
+        for (const auto& tree : view->materialize()) {
+            out.write("Reloaded: ");
+            tree->print(out);
+            out.write('\n');
+        }
+    }
+
+    // Round trip a large tree to compare reload time with the serialized size
+    unique_ptr<ASTNode> tree = make_unique<NumberNode>(0);
+    for (int i = 1; i < 1000000; i++) {
+        tree = make_unique<BinaryOpNode>('+', move(tree), make_unique<VariableNode>("v" + to_string(i % 1000)));
+    }
+    AstWriter bigWriter;
+    bigWriter.add(AssignmentNode(make_unique<VariableNode>("big"), move(tree)));
+    string bytes = bigWriter.finish();
+    ofstream(path, ios::binary) << bytes;
+
+    auto start = chrono::steady_clock::now();
+    MappedFile file(path);
+    auto view = file ? AstView::open(file.bytes()) : nullopt;
+    auto opened = chrono::steady_clock::now();
+    vector<unique_ptr<ASTNode>> trees;
+    if (view) trees = view->materialize();
+    auto materialized = chrono::steady_clock::now();
+
+    out.write("Big tree: ");
+    out.write(static_cast<int>(bytes.size()));
+    out.write(" bytes, ");
+    out.write(static_cast<int>(view ? view->nodeCount() : 0));
+    out.write(" nodes, opened and validated in ");
+    out.write(static_cast<int>(chrono::duration_cast<chrono::microseconds>(opened - start).count()));
+    out.write(" us, materialized in ");
+    out.write(static_cast<int>(chrono::duration_cast<chrono::microseconds>(materialized - opened).count()));
+    out.write(" us\n");
+
+    filesystem::remove(path);
+    return view ? 0 : 1;
+}
@@ -0,0 +1,360 @@
+// orParser tries every alternative in order even when the first character rules it out; give each rule a FIRST set and dispatch on the lookahead character with a jump table
+
+
+#include <iostream>
+#include <string>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <cctype>
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// Define a parser combinator function type
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string>>(const string&)>;
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// A parser together with its FIRST set: the characters it can start with.
+// A nullable rule can succeed without consuming input, so it is viable for
+// any lookahead, including the end of the input.
+struct Rule {
+    Parser parse;
+    CharSet first;
+    bool nullable = false;
+
+    optional<pair<unique_ptr<ASTNode>, string>> operator()(const string& input) const {
+        return parse(input);
+    }
+};
+
+// Number of alternatives invoked by orParser, to show the effect of dispatch
+size_t alternativesInvoked = 0;
+
+// Parser combinator function to parse a single character
+Rule charParser(char c) {
+    Parser parse = [c](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    };
+    return Rule{parse, CharSet(c)};
+}
+
+// Jump table for an orParser: for lookahead byte c the viable alternatives
+// are candidates[start[c]] .. candidates[start[c + 1] - 1], in their original
+// order. Row 256 stands for the end of the input.
+struct DispatchTable {
+    vector<Parser> alternatives;
+    array<uint32_t, 258> start{};
+    vector<uint16_t> candidates;
+};
+
+// OR combinator to combine multiple rules with predictive dispatch. The table
+// owns copies of the alternatives, so the result does not depend on the
+// lifetime of its arguments.
+template<typename... Rules>
+Rule orParser(Rules... rules) {
+    vector<Rule> ruleList = {rules...};
+    auto table = make_shared<DispatchTable>();
+
+    CharSet first;
+    bool nullable = false;
+    for (const auto& rule : ruleList) {
+        table->alternatives.push_back(rule.parse);
+        first = first | rule.first;
+        nullable = nullable || rule.nullable;
+    }
+
+    for (int c = 0; c <= 256; c++) {
+        table->start[c] = static_cast<uint32_t>(table->candidates.size());
+        for (size_t i = 0; i < ruleList.size(); i++) {
+            if (ruleList[i].nullable || (c < 256 && ruleList[i].first.contains(static_cast<unsigned char>(c)))) {
+                table->candidates.push_back(static_cast<uint16_t>(i));
+            }
+        }
+    }
+    table->start[257] = static_cast<uint32_t>(table->candidates.size());
+
+    Parser parse = [table](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        int c = input.empty() ? 256 : static_cast<unsigned char>(input[0]);
+        for (uint32_t i = table->start[c]; i < table->start[c + 1]; i++) {
+            alternativesInvoked++;
+            if (auto result = table->alternatives[table->candidates[i]](input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+    return Rule{parse, first, nullable};
+}
+
+// AND combinator to combine rules sequentially
+Rule andParser(Rule first, Rule second) {
+    Parser parse = [first, second](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        if (auto firstResult = first(input); firstResult) {
+            auto remainingInput = firstResult->second;
+            if (auto secondResult = second(remainingInput); secondResult) {
+                return make_pair(nullptr, secondResult->second); // Combine results
+            }
+        }
+        return nullopt;
+    };
+    CharSet firstSet = first.nullable ? first.first | second.first : first.first;
+    return Rule{parse, firstSet, first.nullable && second.nullable};
+}
+
+// Token combinator: skip leading whitespace, then run the rule
+Rule lexeme(Rule rule) {
+    Parser parse = [rule](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        size_t pos = 0;
+        while (pos < input.size() && spaces.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return rule(pos == 0 ? input : input.substr(pos));
+    };
+    return Rule{parse, rule.first | spaces, rule.nullable};
+}
+
+// Chain combinator for left recursive rules: operand (op operand)*
+Rule chainLeftParser(Rule operand, const string& operators) {
+    vector<pair<char, Rule>> operatorRules;
+    for (char op : operators) {
+        operatorRules.emplace_back(op, lexeme(charParser(op)));
+    }
+
+    Parser parse = [operand, operatorRules](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        unique_ptr<ASTNode> tree = move(result->first);
+        string remaining = move(result->second);
+
+        while (true) {
+            optional<pair<unique_ptr<ASTNode>, string>> operatorResult;
+            char op = 0;
+            for (const auto& [symbol, rule] : operatorRules) {
+                if ((operatorResult = rule(remaining))) {
+                    op = symbol;
+                    break;
+                }
+            }
+            if (!operatorResult) break;
+
+            auto operandResult = operand(operatorResult->second);
+            if (!operandResult) break;
+
+            tree = make_unique<BinaryOpNode>(op, move(tree), move(operandResult->first));
+            remaining = move(operandResult->second);
+        }
+
+        return make_pair(move(tree), move(remaining));
+    };
+    return Rule{parse, operand.first, operand.nullable};
+}
+
+// Parser for variable names
+Rule variableParser{
+    [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        if (input.empty() || !letters.contains(static_cast<unsigned char>(input[0]))) {
+            return nullopt;
+        }
+
+        size_t pos = 1;
+        while (pos < input.size() && identifierChars.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+
+        return make_pair(make_unique<VariableNode>(input.substr(0, pos)), input.substr(pos));
+    },
+    letters
+};
+
+// Parser for numbers (sequence of digits)
+Rule numberParser{
+    [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        size_t pos = 0;
+        while (pos < input.size() && digits.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        int value = 0;
+        if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+            return nullopt;
+        }
+        return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+    },
+    digits
+};
+
+// Parser for a term (number or variable)
+Rule termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Rule expressionParser = chainLeftParser(termParser, "+");
+
+// Parser for the '=' operator
+Rule equalsParser = lexeme(charParser('='));
+
+// Parser for assignment (variable = expression)
+Rule assignmentParser{
+    [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        auto variableResult = lexeme(variableParser)(input);
+        if (!variableResult) return nullopt;
+
+        auto equalsResult = equalsParser(variableResult->second);
+        if (!equalsResult) return nullopt;
+
+        auto expressionResult = expressionParser(equalsResult->second);
+        if (!expressionResult) return nullopt;
+
+        return make_pair(
+            make_unique<AssignmentNode>(move(variableResult->first), move(expressionResult->first)),
+            expressionResult->second
+        );
+    },
+    letters | spaces
+};
+
+// Parser for the ';' statement separator
+Rule semicolonParser = charParser(';');
+
+// Combine parsers using the OR combinator
+Rule combinedParser = orParser(assignmentParser, expressionParser, semicolonParser);
+
+// Test the parser
+int main() {
+    string input = "x = 42 + y_2; 7 + x; y_2 = x + 1; ? z";
+
+    // Parse the input
+    size_t startPos = 0;
+    size_t attempts = 0;
+    while (startPos < input.size()) {
+        attempts++;
+        if (auto result = combinedParser(input.substr(startPos)); result) {
+            unique_ptr<ASTNode> node = move(result->first);
+            string remaining = result->second;
+            if (node) {
+                cout << "Parsed: ";
+                node->print();
+                cout << endl;
+            }
+            startPos = input.size() - remaining.size();
+        } else {
+            // Skip invalid characters
+            startPos++;
+        }
+    }
+
+    cout << "Alternatives invoked: " << alternativesInvoked << " for " << attempts << " top-level attempts" << endl;
+
+    return 0;
+}
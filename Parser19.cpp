@@ -0,0 +1,335 @@
+// every parser has to return a unique_ptr<ASTNode> even when it only matches '=' or an alnum character; make the combinators generic over the result type so only the top-level rules build nodes
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Result of a parser producing a T: the value and the remaining input
+template<typename T>
+using Result = optional<pair<T, string_view>>;
+
+// Define a parser combinator function type, generic over the result type.
+// The input is a view, so consuming characters never copies the rest of it.
+template<typename T>
+using Parser = function<Result<T>(string_view)>;
+
+// Value of rules that only recognize input
+struct Unit {};
+
+// Parser combinator function to parse a single character
+Parser<char> charParser(char c) {
+    return [c](string_view input) -> Result<char> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(c, input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Parser combinator function to parse any character of a set
+Parser<char> charSetParser(CharSet set) {
+    return [set](string_view input) -> Result<char> {
+        if (!input.empty() && set.contains(static_cast<unsigned char>(input[0]))) {
+            return make_pair(input[0], input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Map combinator: transform the value of a successful parse
+template<typename T, typename F>
+auto mapParser(Parser<T> parser, F f) -> Parser<decltype(f(declval<T>()))> {
+    using U = decltype(f(declval<T>()));
+    return [parser, f](string_view input) -> Result<U> {
+        if (auto result = parser(input); result) {
+            return make_pair(f(move(result->first)), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Sequence combinator: run the parsers one after another and collect their values in a tuple
+template<typename T, typename... Ts>
+Parser<tuple<T, Ts...>> seqParser(Parser<T> first, Parser<Ts>... rest) {
+    if constexpr (sizeof...(Ts) == 0) {
+        return mapParser(first, [](T value) { return tuple<T>(move(value)); });
+    } else {
+        Parser<tuple<Ts...>> others = seqParser(rest...);
+        return [first, others](string_view input) -> Result<tuple<T, Ts...>> {
+            auto firstResult = first(input);
+            if (!firstResult) return nullopt;
+
+            auto othersResult = others(firstResult->second);
+            if (!othersResult) return nullopt;
+
+            return make_pair(tuple_cat(tuple<T>(move(firstResult->first)), move(othersResult->first)),
+                             othersResult->second);
+        };
+    }
+}
+
+// OR combinator to combine multiple parsers of the same result type
+template<typename T, typename... Parsers>
+Parser<T> orParser(Parser<T> first, Parsers... rest) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser<T>> parserList = {first, rest...};
+    return [parserList](string_view input) -> Result<T> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Skip combinator: run the parser and drop its value
+template<typename T>
+Parser<Unit> skipParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        if (auto result = parser(input); result) {
+            return make_pair(Unit{}, result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Skip zero or more repetitions of a parser without collecting anything
+template<typename T>
+Parser<Unit> skipManyParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        while (auto result = parser(input)) {
+            if (result->second.size() == input.size()) break;
+            input = result->second;
+        }
+        return make_pair(Unit{}, input);
+    };
+}
+
+// Run ignored first, then parser, keeping only the value of parser
+template<typename T, typename U>
+Parser<U> ignoreThen(Parser<T> ignored, Parser<U> parser) {
+    return [ignored, parser](string_view input) -> Result<U> {
+        auto ignoredResult = ignored(input);
+        if (!ignoredResult) return nullopt;
+        return parser(ignoredResult->second);
+    };
+}
+
+// Span combinator: the value is the text the parser consumed, not whatever it built
+template<typename T>
+Parser<string_view> spanParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<string_view> {
+        if (auto result = parser(input); result) {
+            size_t length = input.size() - result->second.size();
+            return make_pair(input.substr(0, length), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+template<typename T>
+Parser<T> lexeme(Parser<T> parser) {
+    return ignoreThen(skipManyParser(charSetParser(spaces)), parser);
+}
+
+// Chain combinator for left recursive rules: operand (op operand)*, folded with combine
+template<typename T, typename F>
+Parser<T> chainLeftParser(Parser<T> operand, Parser<char> op, F combine) {
+    return [operand, op, combine](string_view input) -> Result<T> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        T value = move(result->first);
+        string_view remaining = result->second;
+        while (auto opResult = op(remaining)) {
+            auto operandResult = operand(opResult->second);
+            if (!operandResult) break;
+            value = combine(opResult->first, move(value), move(operandResult->first));
+            remaining = operandResult->second;
+        }
+        return make_pair(move(value), remaining);
+    };
+}
+
+// Character level rules: they return plain chars and spans and allocate nothing per call
+Parser<char> alnumParser = charSetParser(letters | digits);
+Parser<char> underscoreParser = charParser('_');
+Parser<string_view> identifierParser =
+    spanParser(seqParser(charSetParser(letters), skipManyParser(orParser(alnumParser, underscoreParser))));
+Parser<string_view> digitsParser = spanParser(seqParser(charSetParser(digits), skipManyParser(charSetParser(digits))));
+
+// Node level rules: only these construct AST nodes
+using Node = unique_ptr<ASTNode>;
+
+Parser<Node> variableParser = mapParser(identifierParser, [](string_view name) -> Node {
+    return make_unique<VariableNode>(string(name));
+});
+
+// A literal that does not fit an int fails the parse
+Parser<Node> numberParser = [](string_view input) -> Result<Node> {
+    auto digitsResult = digitsParser(input);
+    if (!digitsResult) return nullopt;
+    string_view text = digitsResult->first;
+    int value = 0;
+    if (from_chars(text.data(), text.data() + text.size(), value).ec != errc()) return nullopt;
+    return make_pair(make_unique<NumberNode>(value), digitsResult->second);
+};
+
+// Parser for a term (number or variable)
+Parser<Node> termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser<Node> expressionParser = chainLeftParser(termParser, lexeme(charParser('+')), [](char op, Node left, Node right) -> Node {
+    return make_unique<BinaryOpNode>(op, move(left), move(right));
+});
+
+// Parser for assignment (variable = expression)
+Parser<Node> assignmentParser = mapParser(
+    seqParser(lexeme(variableParser), skipParser(lexeme(charParser('='))), expressionParser),
+    [](tuple<Node, Unit, Node> parts) -> Node {
+        return make_unique<AssignmentNode>(move(get<0>(parts)), move(get<2>(parts)));
+    });
+
+// Test the parser
+int main() {
+    string input = "x = 42 + y_2";
+
+    // Low level rules yield plain values
+    if (auto result = identifierParser(input); result) {
+        cout << "Identifier span: " << result->first << endl;
+    }
+    if (auto result = seqParser(lexeme(charParser('=')), lexeme(digitsParser))(" = 42"); result) {
+        cout << "Sequence: '" << get<0>(result->first) << "' then '" << get<1>(result->first) << "'" << endl;
+    }
+
+    // Top level rules build the tree
+    for (string_view statement : {"x = 42 + y_2", "total = x + x + 7"}) {
+        if (auto result = assignmentParser(statement); result) {
+            cout << "Parsed: ";
+            result->first->print();
+            cout << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,538 @@
+// add many, many1, sepBy, count and takeWhile combinators that write into caller provided or arena backed containers instead of growing a string one push_back at a time
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Result of a parser producing a T: the value and the remaining input
+template<typename T>
+using Result = optional<pair<T, string_view>>;
+
+// Define a parser combinator function type, generic over the result type.
+// The input is a view, so consuming characters never copies the rest of it.
+template<typename T>
+using Parser = function<Result<T>(string_view)>;
+
+// Value of rules that only recognize input
+struct Unit {};
+
+// Parser combinator function to parse a single character
+Parser<char> charParser(char c) {
+    return [c](string_view input) -> Result<char> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(c, input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Parser combinator function to parse any character of a set
+Parser<char> charSetParser(CharSet set) {
+    return [set](string_view input) -> Result<char> {
+        if (!input.empty() && set.contains(static_cast<unsigned char>(input[0]))) {
+            return make_pair(input[0], input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Map combinator: transform the value of a successful parse
+template<typename T, typename F>
+auto mapParser(Parser<T> parser, F f) -> Parser<decltype(f(declval<T>()))> {
+    using U = decltype(f(declval<T>()));
+    return [parser, f](string_view input) -> Result<U> {
+        if (auto result = parser(input); result) {
+            return make_pair(f(move(result->first)), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Sequence combinator: run the parsers one after another and collect their values in a tuple
+template<typename T, typename... Ts>
+Parser<tuple<T, Ts...>> seqParser(Parser<T> first, Parser<Ts>... rest) {
+    if constexpr (sizeof...(Ts) == 0) {
+        return mapParser(first, [](T value) { return tuple<T>(move(value)); });
+    } else {
+        Parser<tuple<Ts...>> others = seqParser(rest...);
+        return [first, others](string_view input) -> Result<tuple<T, Ts...>> {
+            auto firstResult = first(input);
+            if (!firstResult) return nullopt;
+
+            auto othersResult = others(firstResult->second);
+            if (!othersResult) return nullopt;
+
+            return make_pair(tuple_cat(tuple<T>(move(firstResult->first)), move(othersResult->first)),
+                             othersResult->second);
+        };
+    }
+}
+
+// OR combinator to combine multiple parsers of the same result type
+template<typename T, typename... Parsers>
+Parser<T> orParser(Parser<T> first, Parsers... rest) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser<T>> parserList = {first, rest...};
+    return [parserList](string_view input) -> Result<T> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Skip combinator: run the parser and drop its value
+template<typename T>
+Parser<Unit> skipParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        if (auto result = parser(input); result) {
+            return make_pair(Unit{}, result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Skip zero or more repetitions of a parser without collecting anything
+template<typename T>
+Parser<Unit> skipManyParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        while (auto result = parser(input)) {
+            if (result->second.size() == input.size()) break;
+            input = result->second;
+        }
+        return make_pair(Unit{}, input);
+    };
+}
+
+// Run ignored first, then parser, keeping only the value of parser
+template<typename T, typename U>
+Parser<U> ignoreThen(Parser<T> ignored, Parser<U> parser) {
+    return [ignored, parser](string_view input) -> Result<U> {
+        auto ignoredResult = ignored(input);
+        if (!ignoredResult) return nullopt;
+        return parser(ignoredResult->second);
+    };
+}
+
+// Span combinator: the value is the text the parser consumed, not whatever it built
+template<typename T>
+Parser<string_view> spanParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<string_view> {
+        if (auto result = parser(input); result) {
+            size_t length = input.size() - result->second.size();
+            return make_pair(input.substr(0, length), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+template<typename T>
+Parser<T> lexeme(Parser<T> parser) {
+    return ignoreThen(skipManyParser(charSetParser(spaces)), parser);
+}
+
+// Chain combinator for left recursive rules: operand (op operand)*, folded with combine
+template<typename T, typename F>
+Parser<T> chainLeftParser(Parser<T> operand, Parser<char> op, F combine) {
+    return [operand, op, combine](string_view input) -> Result<T> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        T value = move(result->first);
+        string_view remaining = result->second;
+        while (auto opResult = op(remaining)) {
+            auto operandResult = operand(opResult->second);
+            if (!operandResult) break;
+            value = combine(opResult->first, move(value), move(operandResult->first));
+            remaining = operandResult->second;
+        }
+        return make_pair(move(value), remaining);
+    };
+}
+
+// Run parser, then ignored, keeping only the value of parser
+template<typename T, typename U>
+Parser<T> thenIgnore(Parser<T> parser, Parser<U> ignored) {
+    return [parser, ignored](string_view input) -> Result<T> {
+        auto result = parser(input);
+        if (!result) return nullopt;
+        auto ignoredResult = ignored(result->second);
+        if (!ignoredResult) return nullopt;
+        return make_pair(move(result->first), ignoredResult->second);
+    };
+}
+
+// Take the longest prefix of characters in a set. The value is a span of the
+// input, so no container is involved at all.
+Parser<string_view> takeWhileParser(CharSet set, size_t minimum = 0) {
+    return [set, minimum](string_view input) -> Result<string_view> {
+        size_t length = 0;
+        while (length < input.size() && set.contains(static_cast<unsigned char>(input[length]))) {
+            length++;
+        }
+        if (length < minimum) return nullopt;
+        return make_pair(input.substr(0, length), input.substr(length));
+    };
+}
+
+// Bump allocator for repetition results; everything is released at once by reset()
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment) {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment;
+        if (!current || padding + size > remaining) {
+            size_t capacity = max(blockSize, size + alignment);
+            blocks.push_back(make_unique<char[]>(capacity));
+            current = blocks.back().get();
+            remaining = capacity;
+            padding = (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment;
+        }
+        void* memory = current + padding;
+        current += padding + size;
+        remaining -= padding + size;
+        used += size;
+        return memory;
+    }
+
+    void reset() {
+        blocks.clear();
+        current = nullptr;
+        remaining = 0;
+        used = 0;
+    }
+
+    size_t bytesUsed() const { return used; }
+
+private:
+    vector<unique_ptr<char[]>> blocks;
+    char* current = nullptr;
+    size_t remaining = 0;
+    size_t blockSize;
+    size_t used = 0;
+};
+
+// Exactly sized array of values living in an Arena
+template<typename T>
+struct ArenaSpan {
+    const T* items = nullptr;
+    size_t count = 0;
+
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+    size_t size() const { return count; }
+    const T& operator[](size_t i) const { return items[i]; }
+};
+
+// Per element type scratch stack shared by all repetitions of that type. A
+// repetition appends above its mark and truncates back when done, so nested
+// repetitions of the same type share one buffer whose capacity is kept
+// between calls, and growth stops once the largest list has been seen.
+template<typename T>
+vector<T>& repetitionScratch() {
+    thread_local vector<T> scratch;
+    return scratch;
+}
+
+// Copy the items above mark from the scratch stack into one exactly sized
+// arena allocation
+template<typename T>
+ArenaSpan<T> moveToArena(Arena& arena, vector<T>& scratch, size_t mark) {
+    static_assert(is_trivially_destructible_v<T>, "arena items are never destroyed");
+    size_t count = scratch.size() - mark;
+    T* items = count ? static_cast<T*>(arena.allocate(count * sizeof(T), alignof(T))) : nullptr;
+    uninitialized_copy(scratch.begin() + mark, scratch.end(), items);
+    scratch.resize(mark);
+    return ArenaSpan<T>{items, count};
+}
+
+// Append results of parser to sink until it fails, returning the remaining
+// input, or nullopt (with sink unchanged) when fewer than minimum matched
+template<typename T, typename Container>
+optional<string_view> collectMany(const Parser<T>& parser, Container& sink, string_view input, size_t minimum) {
+    size_t start = sink.size();
+    while (auto result = parser(input)) {
+        if (result->second.size() == input.size()) break;
+        sink.push_back(move(result->first));
+        input = result->second;
+    }
+    if (sink.size() - start < minimum) {
+        sink.resize(start);
+        return nullopt;
+    }
+    return input;
+}
+
+// Append zero or more results of parser to a caller provided container and
+// return how many were added. The caller decides when to clear the container,
+// so its capacity is reused across parses.
+template<typename T, typename Container>
+Parser<size_t> manyInto(Parser<T> parser, Container& sink, size_t minimum = 0) {
+    return [parser, &sink, minimum](string_view input) -> Result<size_t> {
+        size_t start = sink.size();
+        auto remaining = collectMany(parser, sink, input, minimum);
+        if (!remaining) return nullopt;
+        return make_pair(sink.size() - start, *remaining);
+    };
+}
+
+// Zero or more repetitions collected into the arena
+template<typename T>
+Parser<ArenaSpan<T>> manyParser(Parser<T> parser, Arena& arena, size_t minimum = 0) {
+    return [parser, &arena, minimum](string_view input) -> Result<ArenaSpan<T>> {
+        vector<T>& scratch = repetitionScratch<T>();
+        size_t mark = scratch.size();
+        auto remaining = collectMany(parser, scratch, input, minimum);
+        if (!remaining) return nullopt;
+        return make_pair(moveToArena(arena, scratch, mark), *remaining);
+    };
+}
+
+// One or more repetitions collected into the arena
+template<typename T>
+Parser<ArenaSpan<T>> many1Parser(Parser<T> parser, Arena& arena) {
+    return manyParser(parser, arena, 1);
+}
+
+// Zero or more items separated by sep, collected into the arena
+template<typename T, typename U>
+Parser<ArenaSpan<T>> sepByParser(Parser<T> item, Parser<U> sep, Arena& arena) {
+    return [item, sep, &arena](string_view input) -> Result<ArenaSpan<T>> {
+        vector<T>& scratch = repetitionScratch<T>();
+        size_t mark = scratch.size();
+        if (auto result = item(input); result) {
+            scratch.push_back(move(result->first));
+            input = result->second;
+            while (auto sepResult = sep(input)) {
+                auto itemResult = item(sepResult->second);
+                if (!itemResult) break;
+                scratch.push_back(move(itemResult->first));
+                input = itemResult->second;
+            }
+        }
+        return make_pair(moveToArena(arena, scratch, mark), input);
+    };
+}
+
+// Exactly n repetitions; the arena array is sized up front
+template<typename T>
+Parser<ArenaSpan<T>> countParser(size_t n, Parser<T> parser, Arena& arena) {
+    static_assert(is_trivially_destructible_v<T>, "arena items are never destroyed");
+    return [n, parser, &arena](string_view input) -> Result<ArenaSpan<T>> {
+        vector<T>& scratch = repetitionScratch<T>();
+        size_t mark = scratch.size();
+        scratch.reserve(mark + n);
+        for (size_t i = 0; i < n; i++) {
+            auto result = parser(input);
+            if (!result) {
+                scratch.resize(mark);
+                return nullopt;
+            }
+            scratch.push_back(move(result->first));
+            input = result->second;
+        }
+        return make_pair(moveToArena(arena, scratch, mark), input);
+    };
+}
+
+// Character level rules: spans of the input, no per character loop building a string
+Parser<string_view> identifierParser = spanParser(seqParser(charSetParser(letters), takeWhileParser(identifierChars)));
+Parser<string_view> digitsParser = takeWhileParser(digits, 1);
+
+// Node level rules: only these construct AST nodes
+using Node = unique_ptr<ASTNode>;
+
+Parser<Node> variableParser = mapParser(identifierParser, [](string_view name) -> Node {
+    return make_unique<VariableNode>(string(name));
+});
+
+// A literal that does not fit an int fails the parse
+Parser<Node> numberParser = [](string_view input) -> Result<Node> {
+    auto digitsResult = digitsParser(input);
+    if (!digitsResult) return nullopt;
+    string_view text = digitsResult->first;
+    int value = 0;
+    if (from_chars(text.data(), text.data() + text.size(), value).ec != errc()) return nullopt;
+    return make_pair(make_unique<NumberNode>(value), digitsResult->second);
+};
+
+// Parser for a term (number or variable)
+Parser<Node> termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser<Node> expressionParser = chainLeftParser(termParser, lexeme(charParser('+')), [](char op, Node left, Node right) -> Node {
+    return make_unique<BinaryOpNode>(op, move(left), move(right));
+});
+
+// Parser for assignment (variable = expression)
+Parser<Node> assignmentParser = mapParser(
+    seqParser(lexeme(variableParser), skipParser(lexeme(charParser('='))), expressionParser),
+    [](tuple<Node, Unit, Node> parts) -> Node {
+        return make_unique<AssignmentNode>(move(get<0>(parts)), move(get<2>(parts)));
+    });
+
+// Test the parser
+int main() {
+    Arena arena;
+
+    // Argument list: the names are spans of the input stored in one arena array
+    string_view call = "f(alpha, beta_2, gamma, d)";
+    auto argumentsParser = ignoreThen(seqParser(identifierParser, charParser('(')),
+                                      thenIgnore(sepByParser(lexeme(identifierParser), lexeme(charParser(',')), arena),
+                                                 lexeme(charParser(')'))));
+    if (auto result = argumentsParser(call); result) {
+        cout << "Arguments:";
+        for (string_view name : result->first) {
+            cout << " " << name;
+        }
+        cout << endl;
+    }
+
+    // Fixed count: three digits into an array sized before parsing
+    if (auto result = countParser(3, charSetParser(digits), arena)("2024"); result) {
+        cout << "Count: " << string_view(result->first.items, result->first.size()) << ", left " << result->second << endl;
+    }
+
+    // Statement list: owning nodes are appended to a caller provided vector
+    // that is reused, so its capacity carries over from one program to the next
+    vector<Node> statements;
+    auto programParser = manyInto(thenIgnore(assignmentParser, lexeme(charParser(';'))), statements, 1);
+    for (string_view program : {"x = 42 + y_2; total = x + x + 7; y_2 = 1;", "a = 1; b = a + 1;"}) {
+        statements.clear();
+        if (auto result = programParser(program); result) {
+            cout << "Program with " << result->first << " statements (capacity " << statements.capacity() << ")" << endl;
+            for (const auto& statement : statements) {
+                cout << "  Parsed: ";
+                statement->print();
+                cout << endl;
+            }
+        }
+    }
+
+    cout << "Arena bytes used: " << arena.bytesUsed() << endl;
+
+    return 0;
+}
@@ -0,0 +1,419 @@
+// expressions evaluated billions of times are slow to walk as BinaryOpNode trees; compile a parsed tree into nested type specialized lambdas, optionally emit standalone C++ for it, and benchmark against tree walking
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Variable slots: each distinct variable name gets an index into the value array
+class SlotMap {
+public:
+    int slot(const string& name) {
+        auto [it, inserted] = slots.try_emplace(name, static_cast<int>(names.size()));
+        if (inserted) {
+            names.push_back(name);
+        }
+        return it->second;
+    }
+
+    const vector<string>& slotNames() const { return names; }
+    size_t size() const { return names.size(); }
+
+private:
+    unordered_map<string, int> slots;
+    vector<string> names;
+};
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+    // Tree walking evaluation over the slot values
+    virtual int64_t evaluate(const int64_t* values) const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    int slot = -1;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+    int64_t evaluate(const int64_t* values) const override {
+        return values[slot];
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+    int64_t evaluate(const int64_t*) const override {
+        return value;
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+    int64_t evaluate(const int64_t* values) const override {
+        int64_t l = left->evaluate(values);
+        int64_t r = right->evaluate(values);
+        switch (op) {
+        case '+': return l + r;
+        case '-': return l - r;
+        default: return l * r;
+        }
+    }
+};
+
+// Define a parser combinator function type
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string>>(const string&)>;
+
+// Parser combinator function to parse a single character
+Parser charParser(char c) {
+    return [c](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser> parserList = {parsers...};
+    return [parserList](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+Parser lexeme(Parser parser) {
+    return [parser](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        size_t pos = 0;
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return parser(pos == 0 ? input : input.substr(pos));
+    };
+}
+
+// Chain combinator for left recursive rules of the form
+//     rule := rule op operand | operand
+// Instead of recursing, it parses one operand and then loops over
+// (op operand) pairs, folding each into a new BinaryOpNode whose left child
+// is the tree built so far. The stack depth is constant in the chain length.
+Parser chainLeftParser(Parser operand, const string& operators) {
+    vector<pair<char, Parser>> operatorParsers;
+    for (char op : operators) {
+        operatorParsers.emplace_back(op, lexeme(charParser(op)));
+    }
+
+    return [operand, operatorParsers](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        unique_ptr<ASTNode> tree = move(result->first);
+        string remaining = move(result->second);
+
+        while (true) {
+            optional<pair<unique_ptr<ASTNode>, string>> operatorResult;
+            char op = 0;
+            for (const auto& [symbol, parser] : operatorParsers) {
+                if ((operatorResult = parser(remaining))) {
+                    op = symbol;
+                    break;
+                }
+            }
+            if (!operatorResult) break;
+
+            // A trailing operator without an operand is left unconsumed
+            auto operandResult = operand(operatorResult->second);
+            if (!operandResult) break;
+
+            tree = make_unique<BinaryOpNode>(op, move(tree), move(operandResult->first));
+            remaining = move(operandResult->second);
+        }
+
+        return make_pair(move(tree), move(remaining));
+    };
+}
+
+// Parser for variable names
+Parser variableParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    if (input.empty() || !isalpha(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+
+    size_t pos = 1;
+    while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+        pos++;
+    }
+
+    return make_pair(make_unique<VariableNode>(input.substr(0, pos)), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits)
+Parser numberParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    size_t pos = 0;
+    while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    int value = 0;
+    if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+        return nullopt;
+    }
+    return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+};
+
+// Parser for a term (number or variable)
+Parser termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for products: product := product '*' term | term
+Parser productParser = chainLeftParser(termParser, "*");
+
+// Parser for expressions: expr := expr ('+' | '-') product | product
+Parser expressionParser = chainLeftParser(productParser, "+-");
+
+// Give every variable in the tree its slot, left to right
+void resolveSlots(ASTNode& root, SlotMap& slots) {
+    vector<ASTNode*> pending{&root};
+    while (!pending.empty()) {
+        ASTNode* node = pending.back();
+        pending.pop_back();
+        if (auto variable = dynamic_cast<VariableNode*>(node)) {
+            variable->slot = slots.slot(variable->name);
+        } else if (auto binary = dynamic_cast<BinaryOpNode*>(node)) {
+            pending.push_back(binary->right.get());
+            pending.push_back(binary->left.get());
+        }
+    }
+}
+
+// A compiled expression: a closure over the slot values. It is type-erased
+// behind std::function, so every compiled subtree is one indirect call.
+using CompiledExpression = function<int64_t(const int64_t*)>;
+
+bool isLeaf(const ASTNode& node) {
+    return !dynamic_cast<const BinaryOpNode*>(&node);
+}
+
+template<char Op>
+constexpr int64_t apply(int64_t l, int64_t r) {
+    if constexpr (Op == '+') return l + r;
+    else if constexpr (Op == '-') return l - r;
+    else return l * r;
+}
+
+// Closure compiler. The operator and the shapes of the operands are decided
+// once, when compiling: leaves are read inline by their parent's closure and
+// constants are folded. Evaluation still calls through std::function for
+// every compiled subtree, but it never inspects a node, calls a virtual
+// function or switches on an operator.
+class ClosureCompiler {
+public:
+    // Post-order walk with an explicit stack, so deep trees compile without
+    // deep recursion. Operands that are subtrees are compiled before their
+    // parent and wait on the compiled stack.
+    CompiledExpression compile(const ASTNode& root) {
+        vector<pair<const ASTNode*, bool>> pending{{&root, false}};
+        vector<CompiledExpression> compiled;
+        while (!pending.empty()) {
+            auto [node, operandsDone] = pending.back();
+            pending.pop_back();
+            if (isLeaf(*node)) {
+                compiled.push_back(compileLeaf(*node));
+                continue;
+            }
+            const auto& binary = static_cast<const BinaryOpNode&>(*node);
+            if (!operandsDone) {
+                pending.push_back({node, true});
+                if (!isLeaf(*binary.right)) pending.push_back({binary.right.get(), false});
+                if (!isLeaf(*binary.left)) pending.push_back({binary.left.get(), false});
+                continue;
+            }
+            switch (binary.op) {
+            case '+': compiled.push_back(compileBinary<'+'>(binary, compiled)); break;
+            case '-': compiled.push_back(compileBinary<'-'>(binary, compiled)); break;
+            default: compiled.push_back(compileBinary<'*'>(binary, compiled)); break;
+            }
+        }
+        return move(compiled.back());
+    }
+
+private:
+    CompiledExpression compileLeaf(const ASTNode& node) {
+        if (auto number = dynamic_cast<const NumberNode*>(&node)) {
+            int64_t value = number->value;
+            return [value](const int64_t*) { return value; };
+        }
+        int slot = static_cast<const VariableNode&>(node).slot;
+        return [slot](const int64_t* values) { return values[slot]; };
+    }
+
+    static CompiledExpression take(vector<CompiledExpression>& compiled) {
+        CompiledExpression top = move(compiled.back());
+        compiled.pop_back();
+        return top;
+    }
+
+    template<char Op>
+    CompiledExpression compileBinary(const BinaryOpNode& node, vector<CompiledExpression>& compiled) {
+        auto leftNumber = dynamic_cast<const NumberNode*>(node.left.get());
+        auto rightNumber = dynamic_cast<const NumberNode*>(node.right.get());
+        auto leftVariable = dynamic_cast<const VariableNode*>(node.left.get());
+        auto rightVariable = dynamic_cast<const VariableNode*>(node.right.get());
+
+        if (leftNumber && rightNumber) {
+            int64_t value = apply<Op>(leftNumber->value, rightNumber->value);
+            return [value](const int64_t*) { return value; };
+        }
+        if (leftVariable && rightNumber) {
+            int slot = leftVariable->slot;
+            int64_t constant = rightNumber->value;
+            return [slot, constant](const int64_t* values) { return apply<Op>(values[slot], constant); };
+        }
+        if (leftNumber && rightVariable) {
+            int64_t constant = leftNumber->value;
+            int slot = rightVariable->slot;
+            return [constant, slot](const int64_t* values) { return apply<Op>(constant, values[slot]); };
+        }
+        if (leftVariable && rightVariable) {
+            int leftSlot = leftVariable->slot;
+            int rightSlot = rightVariable->slot;
+            return [leftSlot, rightSlot](const int64_t* values) { return apply<Op>(values[leftSlot], values[rightSlot]); };
+        }
+
+        // The left operand of a chain is usually a subtree and the right a leaf.
+        // The right operand's closure, if any, is on top of the stack.
+        CompiledExpression right = isLeaf(*node.right) ? CompiledExpression() : take(compiled);
+        CompiledExpression left = isLeaf(*node.left) ? compileLeaf(*node.left) : take(compiled);
+        if (rightNumber) {
+            int64_t constant = rightNumber->value;
+            return [left, constant](const int64_t* values) { return apply<Op>(left(values), constant); };
+        }
+        if (rightVariable) {
+            int slot = rightVariable->slot;
+            return [left, slot](const int64_t* values) { return apply<Op>(left(values), values[slot]); };
+        }
+        return [left, right](const int64_t* values) { return apply<Op>(left(values), right(values)); };
+    }
+};
+
+// Offline mode: emit the expression as a standalone C++ function
+string emitCpp(const ASTNode& root, const SlotMap& slots, const string& functionName) {
+    ostringstream out;
+    out << "#include <cstdint>\n\n";
+    out << "// Slots:";
+    for (size_t i = 0; i < slots.size(); i++) {
+        out << " [" << i << "] " << slots.slotNames()[i];
+    }
+    out << "\n";
+    out << "int64_t " << functionName << "(const int64_t* values) {\n    return ";
+
+    // Work list of nodes still to emit and punctuation between them; a null
+    // node stands for its text
+    vector<pair<const ASTNode*, string>> pending{{&root, ""}};
+    while (!pending.empty()) {
+        auto [node, text] = move(pending.back());
+        pending.pop_back();
+        if (!node) {
+            out << text;
+        } else if (auto number = dynamic_cast<const NumberNode*>(node)) {
+            out << "int64_t(" << number->value << ")";
+        } else if (auto variable = dynamic_cast<const VariableNode*>(node)) {
+            out << "values[" << variable->slot << "]";
+        } else {
+            const auto& binary = static_cast<const BinaryOpNode&>(*node);
+            pending.push_back({nullptr, ")"});
+            pending.push_back({binary.right.get(), ""});
+            pending.push_back({nullptr, string(" ") + binary.op + " "});
+            pending.push_back({binary.left.get(), ""});
+            out << "(";
+        }
+    }
+    out << ";\n}\n";
+    return out.str();
+}
+
+// Test the parser
+int main(int argc, char* argv[]) {
+    string input = "a * 3 + b * c - 7 + d * a + 2 * 5 - b";
+    long iterations = argc > 1 ? stol(argv[1]) : 20000000;
+
+    auto result = expressionParser(input);
+    if (!result) {
+        cerr << "Cannot parse " << input << endl;
+        return 1;
+    }
+    unique_ptr<ASTNode> tree = move(result->first);
+    SlotMap slots;
+    resolveSlots(*tree, slots);
+
+    cout << "Parsed: ";
+    tree->print();
+    cout << endl << endl << emitCpp(*tree, slots, "evaluate") << endl;
+
+    ClosureCompiler compiler;
+    CompiledExpression compiled = compiler.compile(*tree);
+
+    // Evaluate both ways over changing inputs and compare the results
+    vector<int64_t> values(slots.size());
+    auto run = [&](auto&& evaluate) {
+        int64_t checksum = 0;
+        auto start = chrono::steady_clock::now();
+        for (long i = 0; i < iterations; i++) {
+            if (!values.empty()) values[i % values.size()] = i;
+            checksum += evaluate(values.data());
+        }
+        auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return make_pair(checksum, elapsed);
+    };
+
+    auto [treeChecksum, treeSeconds] = run([&](const int64_t* v) { return tree->evaluate(v); });
+    fill(values.begin(), values.end(), 0);
+    auto [closureChecksum, closureSeconds] = run([&](const int64_t* v) { return compiled(v); });
+
+    cout << "Tree walking: " << treeSeconds * 1e9 / iterations << " ns/eval" << endl;
+    cout << "Closures:     " << closureSeconds * 1e9 / iterations << " ns/eval" << endl;
+    cout << "Speedup:      " << treeSeconds / closureSeconds << "x, results "
+         << (treeChecksum == closureChecksum ? "match" : "differ") << endl;
+
+    return treeChecksum == closureChecksum ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+// the same expression strings like x = 42 + y_2 are parsed again and again from many requests; put a bounded concurrent LRU cache keyed by a content hash in front of the parser that hands out a shared immutable AST
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <cctype>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// Define a parser combinator function type
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string>>(const string&)>;
+
+// Parser combinator function to parse a single character
+Parser charParser(char c) {
+    return [c](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser> parserList = {parsers...};
+    return [parserList](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+Parser lexeme(Parser parser) {
+    return [parser](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        size_t pos = 0;
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return parser(pos == 0 ? input : input.substr(pos));
+    };
+}
+
+// Chain combinator for left recursive rules of the form
+//     rule := rule op operand | operand
+// Instead of recursing, it parses one operand and then loops over
+// (op operand) pairs, folding each into a new BinaryOpNode whose left child
+// is the tree built so far. The stack depth is constant in the chain length.
+Parser chainLeftParser(Parser operand, const string& operators) {
+    vector<pair<char, Parser>> operatorParsers;
+    for (char op : operators) {
+        operatorParsers.emplace_back(op, lexeme(charParser(op)));
+    }
+
+    return [operand, operatorParsers](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        unique_ptr<ASTNode> tree = move(result->first);
+        string remaining = move(result->second);
+
+        while (true) {
+            optional<pair<unique_ptr<ASTNode>, string>> operatorResult;
+            char op = 0;
+            for (const auto& [symbol, parser] : operatorParsers) {
+                if ((operatorResult = parser(remaining))) {
+                    op = symbol;
+                    break;
+                }
+            }
+            if (!operatorResult) break;
+
+            // A trailing operator without an operand is left unconsumed
+            auto operandResult = operand(operatorResult->second);
+            if (!operandResult) break;
+
+            tree = make_unique<BinaryOpNode>(op, move(tree), move(operandResult->first));
+            remaining = move(operandResult->second);
+        }
+
+        return make_pair(move(tree), move(remaining));
+    };
+}
+
+// Parser for variable names
+Parser variableParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    if (input.empty() || !isalpha(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+
+    size_t pos = 1;
+    while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+        pos++;
+    }
+
+    return make_pair(make_unique<VariableNode>(input.substr(0, pos)), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits)
+Parser numberParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    size_t pos = 0;
+    while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    int value = 0;
+    if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+        return nullopt;
+    }
+    return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+};
+
+// Parser for a term (number or variable)
+Parser termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser expressionParser = chainLeftParser(termParser, "+");
+
+// Parser for the '=' operator
+Parser equalsParser = lexeme(charParser('='));
+
+// Parser for assignment (variable = expression)
+Parser assignmentParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    auto variableResult = lexeme(variableParser)(input);
+    if (!variableResult) return nullopt;
+
+    auto equalsResult = equalsParser(variableResult->second);
+    if (!equalsResult) return nullopt;
+
+    auto expressionResult = expressionParser(equalsResult->second);
+    if (!expressionResult) return nullopt;
+
+    return make_pair(
+        make_unique<AssignmentNode>(move(variableResult->first), move(expressionResult->first)),
+        expressionResult->second
+    );
+};
+
+// Fast 64-bit content hash: eight bytes per step with a multiply-xorshift mix
+uint64_t contentHash(string_view text) {
+    constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = text.size() * multiplier;
+    size_t pos = 0;
+    for (; pos + 8 <= text.size(); pos += 8) {
+        uint64_t word;
+        memcpy(&word, text.data() + pos, 8);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, text.data() + pos, text.size() - pos);
+    hash = (hash ^ tail) * multiplier;
+    return hash ^ (hash >> 32);
+}
+
+// Approximate heap footprint of a tree, used for the memory budget
+size_t treeBytes(const ASTNode* root) {
+    size_t bytes = 0;
+    vector<const ASTNode*> pending{root};
+    while (!pending.empty()) {
+        const ASTNode* node = pending.back();
+        pending.pop_back();
+        if (!node) continue;
+        if (auto variable = dynamic_cast<const VariableNode*>(node)) {
+            bytes += sizeof(VariableNode) + (variable->name.size() > 15 ? variable->name.capacity() : 0);
+        } else if (auto binary = dynamic_cast<const BinaryOpNode*>(node)) {
+            bytes += sizeof(BinaryOpNode);
+            pending.push_back(binary->left.get());
+            pending.push_back(binary->right.get());
+        } else if (auto assignment = dynamic_cast<const AssignmentNode*>(node)) {
+            bytes += sizeof(AssignmentNode);
+            pending.push_back(assignment->left.get());
+            pending.push_back(assignment->right.get());
+        } else {
+            bytes += sizeof(NumberNode);
+        }
+    }
+    return bytes;
+}
+
+// Counters of a ParseCache
+struct CacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t bytes;
+    size_t entries;
+};
+
+// Bounded LRU cache of parse results, keyed by a hash of the input text.
+// The cache is split into shards, each with its own lock and LRU list, so
+// concurrent requests for different inputs rarely contend. Trees are shared
+// and immutable: a hit hands out another reference and never copies. Failed
+// parses are cached too, as a null tree.
+class ParseCache {
+public:
+    using Tree = shared_ptr<const ASTNode>;
+
+    ParseCache(Parser parser, size_t memoryBudget, size_t shardCount = 16)
+        : parser(move(parser)), shards(shardCount), shardBudget(memoryBudget / shardCount) {}
+
+    Tree parse(const string& input) {
+        uint64_t hash = contentHash(input);
+        Shard& shard = shards[hash % shards.size()];
+
+        {
+            lock_guard<mutex> lock(shard.lock);
+            if (auto it = shard.index.find(hash); it != shard.index.end() && it->second->input == input) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                hits++;
+                return it->second->tree;
+            }
+        }
+        misses++;
+
+        // Parse outside the lock so a slow parse does not block the shard
+        Tree tree;
+        if (auto result = parser(input); result && result->second.find_first_not_of(" \t\r\n") == string::npos) {
+            tree = Tree(move(result->first));
+        }
+        size_t bytes = sizeof(Entry) + input.capacity() + treeBytes(tree.get());
+
+        lock_guard<mutex> lock(shard.lock);
+        if (auto it = shard.index.find(hash); it != shard.index.end()) {
+            if (it->second->input == input) {
+                // Another thread inserted the same input meanwhile; share its tree
+                return it->second->tree;
+            }
+            // A different input with the same hash: replace it
+            removeEntry(shard, it->second);
+        }
+        shard.lru.push_front(Entry{hash, input, tree, bytes});
+        shard.index[hash] = shard.lru.begin();
+        shard.bytes += bytes;
+        totalBytes += bytes;
+        while (shard.bytes > shardBudget && shard.lru.size() > 1) {
+            removeEntry(shard, prev(shard.lru.end()));
+            evictions++;
+        }
+        return tree;
+    }
+
+    CacheStats stats() const {
+        size_t entries = 0;
+        for (const auto& shard : shards) {
+            lock_guard<mutex> lock(shard.lock);
+            entries += shard.lru.size();
+        }
+        return CacheStats{hits.load(), misses.load(), evictions.load(), totalBytes.load(), entries};
+    }
+
+private:
+    struct Entry {
+        uint64_t hash;
+        string input;
+        Tree tree;
+        size_t bytes;
+    };
+
+    struct Shard {
+        mutable mutex lock;
+        list<Entry> lru;
+        unordered_map<uint64_t, list<Entry>::iterator> index;
+        size_t bytes = 0;
+    };
+
+    void removeEntry(Shard& shard, list<Entry>::iterator entry) {
+        shard.bytes -= entry->bytes;
+        totalBytes -= entry->bytes;
+        shard.index.erase(entry->hash);
+        shard.lru.erase(entry);
+    }
+
+    Parser parser;
+    vector<Shard> shards;
+    size_t shardBudget;
+    atomic<uint64_t> hits{0};
+    atomic<uint64_t> misses{0};
+    atomic<uint64_t> evictions{0};
+    atomic<size_t> totalBytes{0};
+};
+
+// Test the parser
+int main() {
+    ParseCache cache(assignmentParser, 1024 * 1024);
+
+    auto first = cache.parse("x = 42 + y_2");
+    auto second = cache.parse("x = 42 + y_2");
+    cout << "Parsed: ";
+    first->print();
+    cout << endl << "Second lookup shares the tree: " << (first == second ? "yes" : "no") << endl;
+
+    // An out-of-range literal is a parse error, cached like any other
+    auto overflow = cache.parse("z = 99999999999");
+    cout << "Out-of-range literal: " << (overflow ? "parsed" : "rejected") << endl;
+
+    // Many requests over a skewed set of distinct statements from several threads
+    vector<string> statements;
+    for (int i = 0; i < 5000; i++) {
+        statements.push_back("v" + to_string(i) + " = " + to_string(i) + " + a + b_" + to_string(i % 7) + " + 1");
+    }
+
+    auto serve = [&](bool cached, size_t requests, unsigned seed) {
+        mt19937 random(seed);
+        geometric_distribution<int> pick(0.002);
+        size_t parsed = 0;
+        for (size_t i = 0; i < requests; i++) {
+            const string& input = statements[pick(random) % statements.size()];
+            if (cached) {
+                parsed += cache.parse(input) != nullptr;
+            } else {
+                parsed += assignmentParser(input).has_value();
+            }
+        }
+        return parsed;
+    };
+
+    for (bool cached : {false, true}) {
+        unsigned threadCount = max(2u, min(8u, thread::hardware_concurrency()));
+        vector<thread> workers;
+        atomic<size_t> parsed{0};
+        auto start = chrono::steady_clock::now();
+        for (unsigned t = 0; t < threadCount; t++) {
+            workers.emplace_back([&, t] { parsed += serve(cached, 50000, t + 1); });
+        }
+        for (auto& worker : workers) worker.join();
+        auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << (cached ? "Cached:   " : "Uncached: ") << parsed.load() << " requests on " << threadCount
+             << " threads in " << elapsed * 1000 << " ms" << endl;
+    }
+
+    CacheStats stats = cache.stats();
+    cout << "Hits " << stats.hits << ", misses " << stats.misses << ", evictions " << stats.evictions
+         << ", entries " << stats.entries << ", bytes " << stats.bytes << endl;
+
+    return 0;
+}
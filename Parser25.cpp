@@ -0,0 +1,382 @@
+// parsing today needs the whole input string up front; write a C++20 coroutine driver where the parser suspends when it runs out of bytes and resumes when more arrive, so one thread can serve thousands of pipes or sockets
+
+
+#include <iostream>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <cctype>
+#include <coroutine>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// Lazily started coroutine returning a T. Awaiting it runs it to completion
+// and then transfers control straight back to the awaiting coroutine, so
+// nested parse functions suspend and resume as one chain.
+template<typename T>
+class Lazy {
+public:
+    struct promise_type {
+        optional<T> value;
+        coroutine_handle<> continuation = noop_coroutine();
+
+        Lazy get_return_object() {
+            return Lazy(coroutine_handle<promise_type>::from_promise(*this));
+        }
+        suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                coroutine_handle<> await_suspend(coroutine_handle<promise_type> handle) noexcept {
+                    return handle.promise().continuation;
+                }
+                void await_resume() noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+        void return_value(T result) { value = move(result); }
+        void unhandled_exception() { terminate(); }
+    };
+
+    Lazy(Lazy&& other) noexcept : handle(exchange(other.handle, nullptr)) {}
+    Lazy(const Lazy&) = delete;
+    ~Lazy() {
+        if (handle) handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    coroutine_handle<> await_suspend(coroutine_handle<> caller) noexcept {
+        handle.promise().continuation = caller;
+        return handle;
+    }
+    T await_resume() { return move(*handle.promise().value); }
+
+    // Drive a top-level coroutine until its first suspension
+    void start() { handle.resume(); }
+    bool done() const { return handle.done(); }
+
+private:
+    explicit Lazy(coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    coroutine_handle<promise_type> handle;
+};
+
+// Bytes received so far from one input. A parser that needs a byte that has
+// not arrived yet suspends in peek() and is resumed by feed() or close().
+class ByteStream {
+public:
+    void feed(string_view data) {
+        // Drop the consumed prefix before appending so the buffer stays small
+        if (pos > 4096 && pos * 2 > buffer.size()) {
+            buffer.erase(0, pos);
+            pos = 0;
+        }
+        buffer.append(data);
+        resumeWaiting();
+    }
+
+    void close() {
+        closed = true;
+        resumeWaiting();
+    }
+
+    // Awaitable for the next unconsumed byte; nullopt at end of input
+    auto peek() {
+        struct PeekAwaiter {
+            ByteStream& stream;
+            bool await_ready() const { return stream.pos < stream.buffer.size() || stream.closed; }
+            void await_suspend(coroutine_handle<> handle) { stream.waiting = handle; }
+            optional<char> await_resume() const {
+                if (stream.pos < stream.buffer.size()) return stream.buffer[stream.pos];
+                return nullopt;
+            }
+        };
+        return PeekAwaiter{*this};
+    }
+
+    void advance() { pos++; }
+
+private:
+    void resumeWaiting() {
+        if (auto handle = exchange(waiting, nullptr)) {
+            handle.resume();
+        }
+    }
+
+    string buffer;
+    size_t pos = 0;
+    bool closed = false;
+    coroutine_handle<> waiting;
+};
+
+// Incremental parsers. Each one awaits bytes from the stream instead of
+// reading a string, and returns nullptr when its rule does not match.
+Lazy<optional<char>> skipSpaces(ByteStream& in) {
+    while (true) {
+        optional<char> c = co_await in.peek();
+        if (!c || !isspace(static_cast<unsigned char>(*c))) co_return c;
+        in.advance();
+    }
+}
+
+// Parser for variable names
+Lazy<unique_ptr<ASTNode>> variableParser(ByteStream& in) {
+    string name;
+    while (optional<char> c = co_await in.peek()) {
+        bool valid = name.empty() ? isalpha(static_cast<unsigned char>(*c)) : (isalnum(static_cast<unsigned char>(*c)) || *c == '_');
+        if (!valid) break;
+        name.push_back(*c);
+        in.advance();
+    }
+    co_return name.empty() ? nullptr : make_unique<VariableNode>(name);
+}
+
+// Parser for numbers (sequence of digits); a literal that does not fit an
+// int is rejected
+Lazy<unique_ptr<ASTNode>> numberParser(ByteStream& in) {
+    string digits;
+    while (optional<char> c = co_await in.peek()) {
+        if (!isdigit(static_cast<unsigned char>(*c))) break;
+        digits += *c;
+        in.advance();
+    }
+    int value = 0;
+    if (digits.empty() || from_chars(digits.data(), digits.data() + digits.size(), value).ec != errc()) {
+        co_return nullptr;
+    }
+    co_return make_unique<NumberNode>(value);
+}
+
+// Parser for a term (number or variable)
+Lazy<unique_ptr<ASTNode>> termParser(ByteStream& in) {
+    optional<char> c = co_await skipSpaces(in);
+    if (c && isdigit(static_cast<unsigned char>(*c))) co_return co_await numberParser(in);
+    co_return co_await variableParser(in);
+}
+
+// Parser for expressions: term ('+' term)*, folded to the left
+Lazy<unique_ptr<ASTNode>> expressionParser(ByteStream& in) {
+    unique_ptr<ASTNode> tree = co_await termParser(in);
+    if (!tree) co_return nullptr;
+    while (true) {
+        optional<char> c = co_await skipSpaces(in);
+        if (c != '+') co_return tree;
+        in.advance();
+        unique_ptr<ASTNode> right = co_await termParser(in);
+        if (!right) co_return nullptr;
+        tree = make_unique<BinaryOpNode>('+', move(tree), move(right));
+    }
+}
+
+// Parser for one statement: variable '=' expression ';'
+Lazy<unique_ptr<ASTNode>> statementParser(ByteStream& in) {
+    co_await skipSpaces(in);
+    unique_ptr<ASTNode> target = co_await variableParser(in);
+    if (!target || co_await skipSpaces(in) != '=') co_return nullptr;
+    in.advance();
+    unique_ptr<ASTNode> value = co_await expressionParser(in);
+    if (!value || co_await skipSpaces(in) != ';') co_return nullptr;
+    in.advance();
+    co_return make_unique<AssignmentNode>(move(target), move(value));
+}
+
+// Callbacks for the statements of one stream
+struct StatementHandler {
+    function<void(unique_ptr<ASTNode>)> onStatement;
+    function<void()> onError;
+};
+
+// Parse statements until the stream ends. After a syntax error the rest of
+// the statement, up to the next ';', is skipped.
+Lazy<bool> programParser(ByteStream& in, StatementHandler handler) {
+    while (co_await skipSpaces(in)) {
+        if (unique_ptr<ASTNode> statement = co_await statementParser(in)) {
+            handler.onStatement(move(statement));
+            continue;
+        }
+        handler.onError();
+        while (optional<char> c = co_await in.peek()) {
+            in.advance();
+            if (*c == ';') break;
+        }
+    }
+    co_return true;
+}
+
+// One input being parsed: its descriptor, received bytes and suspended parser
+struct Connection {
+    int fd;
+    ByteStream stream;
+    Lazy<bool> parser;
+    size_t statements = 0;
+    size_t errors = 0;
+
+    explicit Connection(int fd)
+        : fd(fd), parser(programParser(stream, {[this](unique_ptr<ASTNode>) { statements++; },
+                                                [this] { errors++; }})) {
+        parser.start();
+    }
+};
+
+// Single threaded event loop: poll every open descriptor, feed whatever
+// arrived to its stream, and let the parser run until it needs more bytes
+void serve(vector<unique_ptr<Connection>>& connections) {
+    vector<pollfd> fds;
+    char chunk[4096];
+    size_t open = connections.size();
+    while (open > 0) {
+        fds.clear();
+        for (const auto& connection : connections) {
+            fds.push_back({connection->fd, POLLIN, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) break;
+
+        for (size_t i = 0; i < fds.size(); i++) {
+            Connection& connection = *connections[i];
+            if (connection.fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t count = read(connection.fd, chunk, sizeof(chunk));
+            if (count > 0) {
+                connection.stream.feed(string_view(chunk, count));
+            } else {
+                close(connection.fd);
+                connection.fd = -1; // poll ignores negative descriptors
+                connection.stream.close();
+                open--;
+            }
+        }
+    }
+}
+
+// Test the parser
+int main(int argc, char* argv[]) {
+    vector<unique_ptr<Connection>> connections;
+
+    // Files given on the command line are parsed as streams too
+    for (int i = 1; i < argc; i++) {
+        int fd = open(argv[i], O_RDONLY);
+        if (fd < 0) {
+            cerr << "Cannot open " << argv[i] << endl;
+            continue;
+        }
+        connections.push_back(make_unique<Connection>(fd));
+    }
+
+    // Otherwise, a writer thread trickles statements into many pipes in small
+    // interleaved fragments, splitting statements at arbitrary bytes
+    thread writer;
+    size_t pipes = 200, statementsPerPipe = 500;
+    if (connections.empty()) {
+        vector<int> writeEnds;
+        for (size_t i = 0; i < pipes; i++) {
+            int ends[2];
+            if (pipe(ends) != 0) break;
+            connections.push_back(make_unique<Connection>(ends[0]));
+            writeEnds.push_back(ends[1]);
+        }
+
+        writer = thread([writeEnds, statementsPerPipe] {
+            vector<string> pending(writeEnds.size());
+            for (size_t i = 0; i < writeEnds.size(); i++) {
+                for (size_t s = 0; s < statementsPerPipe; s++) {
+                    pending[i] += "x" + to_string(s) + " = " + to_string(s) + " + y_" + to_string(i) + ";\n";
+                }
+                pending[i] += "broken = ;";
+            }
+            mt19937 random(42);
+            vector<size_t> offsets(writeEnds.size(), 0);
+            size_t remaining = writeEnds.size();
+            while (remaining > 0) {
+                size_t i = random() % writeEnds.size();
+                if (offsets[i] == pending[i].size()) continue;
+                size_t length = min<size_t>(1 + random() % 64, pending[i].size() - offsets[i]);
+                if (write(writeEnds[i], pending[i].data() + offsets[i], length) < 0) return;
+                offsets[i] += length;
+                if (offsets[i] == pending[i].size()) {
+                    close(writeEnds[i]);
+                    remaining--;
+                }
+            }
+        });
+    }
+
+    serve(connections);
+    if (writer.joinable()) writer.join();
+
+    size_t statements = 0, errors = 0, finished = 0;
+    for (const auto& connection : connections) {
+        statements += connection->statements;
+        errors += connection->errors;
+        finished += connection->parser.done();
+    }
+    cout << "Parsed " << statements << " statements with " << errors << " errors from " << connections.size()
+         << " streams on one thread (" << finished << " parsers finished)" << endl;
+
+    return 0;
+}
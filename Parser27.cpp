@@ -0,0 +1,574 @@
+// before swapping the std::function combinators for faster engines we need proof they parse identically; add a differential fuzz harness that compares engines on random inputs, times every input, and saves mismatches and pathologically slow inputs as regression cases
+
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// Define a parser combinator function type
+using Parser = function<optional<pair<unique_ptr<ASTNode>, string>>(const string&)>;
+
+// Parser combinator function to parse a single character
+Parser charParser(char c) {
+    return [c](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser> parserList = {parsers...};
+    return [parserList](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+Parser lexeme(Parser parser) {
+    return [parser](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        size_t pos = 0;
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return parser(pos == 0 ? input : input.substr(pos));
+    };
+}
+
+// Chain combinator for left recursive rules of the form
+//     rule := rule op operand | operand
+// Instead of recursing, it parses one operand and then loops over
+// (op operand) pairs, folding each into a new BinaryOpNode whose left child
+// is the tree built so far. The stack depth is constant in the chain length.
+Parser chainLeftParser(Parser operand, const string& operators) {
+    vector<pair<char, Parser>> operatorParsers;
+    for (char op : operators) {
+        operatorParsers.emplace_back(op, lexeme(charParser(op)));
+    }
+
+    return [operand, operatorParsers](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        unique_ptr<ASTNode> tree = move(result->first);
+        string remaining = move(result->second);
+
+        while (true) {
+            optional<pair<unique_ptr<ASTNode>, string>> operatorResult;
+            char op = 0;
+            for (const auto& [symbol, parser] : operatorParsers) {
+                if ((operatorResult = parser(remaining))) {
+                    op = symbol;
+                    break;
+                }
+            }
+            if (!operatorResult) break;
+
+            // A trailing operator without an operand is left unconsumed
+            auto operandResult = operand(operatorResult->second);
+            if (!operandResult) break;
+
+            tree = make_unique<BinaryOpNode>(op, move(tree), move(operandResult->first));
+            remaining = move(operandResult->second);
+        }
+
+        return make_pair(move(tree), move(remaining));
+    };
+}
+
+// Parser for variable names
+Parser variableParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    if (input.empty() || !isalpha(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+
+    size_t pos = 1;
+    while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+        pos++;
+    }
+
+    return make_pair(make_unique<VariableNode>(input.substr(0, pos)), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits)
+Parser numberParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    size_t pos = 0;
+    while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    if (pos > 0) {
+        return make_pair(make_unique<NumberNode>(stoi(input.substr(0, pos))), input.substr(pos));
+    } else {
+        return nullopt;
+    }
+};
+
+// Parser for a term (number or variable)
+Parser termParser = lexeme(orParser(numberParser, variableParser));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser expressionParser = chainLeftParser(termParser, "+");
+
+// Parser for the '=' operator
+Parser equalsParser = lexeme(charParser('='));
+
+// Parser for assignment (variable = expression)
+Parser assignmentParser = [](const string& input) -> optional<pair<unique_ptr<ASTNode>, string>> {
+    auto variableResult = lexeme(variableParser)(input);
+    if (!variableResult) return nullopt;
+
+    auto equalsResult = equalsParser(variableResult->second);
+    if (!equalsResult) return nullopt;
+
+    auto expressionResult = expressionParser(equalsResult->second);
+    if (!expressionResult) return nullopt;
+
+    return make_pair(
+        make_unique<AssignmentNode>(move(variableResult->first), move(expressionResult->first)),
+        expressionResult->second
+    );
+};
+
+// Optimized engine: a single pass recursive descent parser over a view. It
+// must accept exactly what assignmentParser accepts and build the same tree.
+class DescentParser {
+public:
+    explicit DescentParser(string_view input) : input(input) {}
+
+    // Returns the tree and the number of bytes consumed; throws out_of_range
+    // on numbers that do not fit an int, like stoi in the reference
+    optional<pair<unique_ptr<ASTNode>, size_t>> parseAssignment() {
+        skipSpaces();
+        auto target = parseVariable();
+        if (!target) return nullopt;
+        skipSpaces();
+        if (!consume('=')) return nullopt;
+        auto value = parseExpression();
+        if (!value) return nullopt;
+        return make_pair(make_unique<AssignmentNode>(move(target), move(value)), pos);
+    }
+
+private:
+    unique_ptr<ASTNode> parseExpression() {
+        auto tree = parseTerm();
+        if (!tree) return nullptr;
+        while (true) {
+            size_t mark = pos;
+            skipSpaces();
+            if (!consume('+')) {
+                pos = mark;
+                break;
+            }
+            auto right = parseTerm();
+            if (!right) {
+                pos = mark;
+                break;
+            }
+            tree = make_unique<BinaryOpNode>('+', move(tree), move(right));
+        }
+        return tree;
+    }
+
+    unique_ptr<ASTNode> parseTerm() {
+        size_t mark = pos;
+        skipSpaces();
+        if (auto number = parseNumber()) return number;
+        if (auto variable = parseVariable()) return variable;
+        pos = mark;
+        return nullptr;
+    }
+
+    unique_ptr<ASTNode> parseNumber() {
+        size_t start = pos;
+        while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) pos++;
+        if (pos == start) return nullptr;
+        int value = 0;
+        if (from_chars(input.data() + start, input.data() + pos, value).ec != errc()) {
+            throw out_of_range("number does not fit an int");
+        }
+        return make_unique<NumberNode>(value);
+    }
+
+    unique_ptr<ASTNode> parseVariable() {
+        size_t start = pos;
+        if (pos >= input.size() || !isalpha(static_cast<unsigned char>(input[pos]))) return nullptr;
+        pos++;
+        while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) pos++;
+        return make_unique<VariableNode>(string(input.substr(start, pos - start)));
+    }
+
+    void skipSpaces() {
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) pos++;
+    }
+
+    bool consume(char c) {
+        if (pos < input.size() && input[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    string_view input;
+    size_t pos = 0;
+};
+
+// Canonical text of a tree, used to compare engines
+string canonical(const ASTNode* node) {
+    ostringstream out;
+    vector<pair<const ASTNode*, const char*>> steps{{node, nullptr}};
+    while (!steps.empty()) {
+        auto [current, text] = steps.back();
+        steps.pop_back();
+        if (text) {
+            out << text;
+        } else if (auto variable = dynamic_cast<const VariableNode*>(current)) {
+            out << "V(" << variable->name << ")";
+        } else if (auto number = dynamic_cast<const NumberNode*>(current)) {
+            out << "N(" << number->value << ")";
+        } else if (auto binary = dynamic_cast<const BinaryOpNode*>(current)) {
+            out << "B" << binary->op << "(";
+            steps.push_back({nullptr, ")"});
+            steps.push_back({binary->right.get(), nullptr});
+            steps.push_back({nullptr, ","});
+            steps.push_back({binary->left.get(), nullptr});
+        } else if (auto assignment = dynamic_cast<const AssignmentNode*>(current)) {
+            out << "A(";
+            steps.push_back({nullptr, ")"});
+            steps.push_back({assignment->right.get(), nullptr});
+            steps.push_back({nullptr, ","});
+            steps.push_back({assignment->left.get(), nullptr});
+        }
+    }
+    return out.str();
+}
+
+// What an engine made of one input. The tree is kept so that it can be
+// compared, and destroyed, outside the timed region.
+struct Outcome {
+    enum Status { Match, NoMatch, Error } status = NoMatch;
+    size_t consumed = 0;
+    unique_ptr<ASTNode> tree;
+};
+
+// Outcome reduced to comparable text
+struct Verdict {
+    Outcome::Status status;
+    size_t consumed;
+    string tree;
+
+    bool operator==(const Verdict& other) const {
+        return status == other.status && consumed == other.consumed && tree == other.tree;
+    }
+};
+
+ostream& operator<<(ostream& out, const Verdict& verdict) {
+    const char* names[] = {"match", "no match", "error"};
+    out << names[verdict.status];
+    if (verdict.status == Outcome::Match) {
+        out << ", consumed " << verdict.consumed << ", " << verdict.tree.substr(0, 120);
+    }
+    return out;
+}
+
+// A parser implementation under test; the first engine is the reference
+struct Engine {
+    string name;
+    function<Outcome(const string&)> parse;
+};
+
+vector<Engine> engines = {
+    {"combinators", [](const string& input) {
+        Outcome outcome;
+        try {
+            if (auto result = assignmentParser(input); result) {
+                outcome = {Outcome::Match, input.size() - result->second.size(), move(result->first)};
+            }
+        } catch (const exception&) {
+            outcome.status = Outcome::Error;
+        }
+        return outcome;
+    }},
+    {"descent", [](const string& input) {
+        Outcome outcome;
+        try {
+            if (auto result = DescentParser(input).parseAssignment(); result) {
+                outcome = {Outcome::Match, result->second, move(result->first)};
+            }
+        } catch (const exception&) {
+            outcome.status = Outcome::Error;
+        }
+        return outcome;
+    }},
+};
+
+// Random inputs: mostly mutated statements, sometimes random bytes, and now
+// and then a long chain to expose super-linear behaviour
+class InputGenerator {
+public:
+    explicit InputGenerator(uint32_t seed) : random(seed) {}
+
+    string next() {
+        string input;
+        switch (random() % 10) {
+        case 0:
+            for (int i = random() % 32; i > 0; i--) input.push_back(static_cast<char>(random()));
+            return input;
+        case 1:
+            input = "total = a";
+            for (int i = 1 + random() % 4000; i > 0; i--) input += " + v" + to_string(random() % 100);
+            return input;
+        default:
+            input = token() + pick({"=", " = ", "==", " ="}) + token();
+            for (int i = random() % 5; i > 0; i--) input += pick({"+", " + ", " +", "++"}) + token();
+            return mutate(input);
+        }
+    }
+
+private:
+    string token() {
+        switch (random() % 6) {
+        case 0: return to_string(random() % 1000);
+        case 1: return to_string(random()) + to_string(random()); // overflows int
+        case 2: return "_x";
+        default: {
+            string name(1, "abcxyzXY"[random() % 8]);
+            for (int i = random() % 4; i > 0; i--) name.push_back("az09_"[random() % 5]);
+            return name;
+        }
+        }
+    }
+
+    string pick(initializer_list<const char*> choices) {
+        return *(choices.begin() + random() % choices.size());
+    }
+
+    string mutate(string input) {
+        const char alphabet[] = " \t\n\v=+;_aZ09\xC3\x80";
+        for (int i = random() % 3; i > 0 && !input.empty(); i--) {
+            size_t at = random() % input.size();
+            char c = alphabet[random() % (sizeof(alphabet) - 1)];
+            switch (random() % 3) {
+            case 0: input.insert(input.begin() + at, c); break;
+            case 1: input.erase(at, 1); break;
+            default: input[at] = c; break;
+            }
+        }
+        return input;
+    }
+
+    mt19937 random;
+};
+
+// Compares the engines input by input, times each run, and keeps the inputs
+// that disagree, and if asked the ones that take too long per byte
+class DifferentialHarness {
+public:
+    DifferentialHarness(filesystem::path regressionDir, double slowNanosPerByte, double slowMillis, bool keepSlowInputs)
+        : regressionDir(move(regressionDir)), slowNanosPerByte(slowNanosPerByte), slowMillis(slowMillis),
+          keepSlowInputs(keepSlowInputs) {}
+
+    // Returns false when the engines disagree
+    bool check(const string& input, bool save = true) {
+        vector<Verdict> outcomes;
+        for (const auto& engine : engines) {
+            auto start = chrono::steady_clock::now();
+            Outcome outcome = engine.parse(input);
+            double millis = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            if (isSlow(millis, input.size())) {
+                // Time it twice more and keep the best run, so one scheduling hiccup is not reported
+                for (int retry = 0; retry < 2; retry++) {
+                    auto again = chrono::steady_clock::now();
+                    engine.parse(input);
+                    millis = min(millis, chrono::duration<double, milli>(chrono::steady_clock::now() - again).count());
+                }
+            }
+            if (isSlow(millis, input.size())) {
+                slowInputs++;
+                // Only a new worst case per engine is reported and saved
+                double nanosPerByte = millis * 1e6 / max<size_t>(input.size(), 1);
+                double& worst = worstNanosPerByte[engine.name];
+                if (nanosPerByte > worst) {
+                    worst = nanosPerByte;
+                    cout << "Slow: " << engine.name << " took " << millis << " ms on " << input.size()
+                         << " bytes (" << nanosPerByte << " ns/byte)" << endl;
+                    if (save && keepSlowInputs) saveRegression("slow-" + engine.name, input);
+                }
+            }
+            outcomes.push_back(Verdict{outcome.status, outcome.consumed, outcome.tree ? canonical(outcome.tree.get()) : ""});
+        }
+
+        for (size_t i = 1; i < engines.size(); i++) {
+            if (!(outcomes[i] == outcomes[0])) {
+                mismatches++;
+                cout << "Mismatch on " << quoted(input.substr(0, 80)) << ":\n  " << engines[0].name << ": "
+                     << outcomes[0] << "\n  " << engines[i].name << ": " << outcomes[i] << endl;
+                if (save) saveRegression("mismatch-" + engines[i].name, input);
+                return false;
+            }
+        }
+        checked++;
+        return true;
+    }
+
+    // Re-run every saved regression case
+    void replay() {
+        if (!filesystem::exists(regressionDir)) return;
+        for (const auto& entry : filesystem::directory_iterator(regressionDir)) {
+            ifstream file(entry.path(), ios::binary);
+            string input((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+            check(input, false);
+            replayed++;
+        }
+    }
+
+    void report() const {
+        cout << "Checked " << checked << " inputs (" << replayed << " replayed): " << mismatches << " mismatches, "
+             << slowInputs << " slow runs" << endl;
+    }
+
+    size_t mismatchCount() const { return mismatches; }
+    size_t savedCount() const { return saved; }
+
+private:
+    bool isSlow(double millis, size_t bytes) const {
+        return millis > slowMillis || (bytes >= 1024 && millis * 1e6 / bytes > slowNanosPerByte);
+    }
+
+    void saveRegression(const string& kind, const string& input) {
+        filesystem::create_directories(regressionDir);
+        size_t hash = std::hash<string>()(input);
+        ofstream(regressionDir / (kind + "-" + to_string(hash) + ".txt"), ios::binary) << input;
+        saved++;
+    }
+
+    filesystem::path regressionDir;
+    double slowNanosPerByte;
+    double slowMillis;
+    bool keepSlowInputs;
+    size_t checked = 0;
+    size_t saved = 0;
+    size_t replayed = 0;
+    size_t mismatches = 0;
+    size_t slowInputs = 0;
+    map<string, double> worstNanosPerByte;
+};
+
+#ifdef PARSER_LIBFUZZER
+// libFuzzer entry point: clang++ -std=c++20 -g -O1 -fsanitize=fuzzer,address -DPARSER_LIBFUZZER Parser27.cpp
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static DifferentialHarness harness(filesystem::temp_directory_path() / "parser27_regressions", 250.0, 1000.0, true);
+    if (!harness.check(string(reinterpret_cast<const char*>(data), size))) {
+        abort();
+    }
+    return 0;
+}
+#else
+// Test the parser
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? stoul(argv[1]) : 20000;
+    // Without an output directory only mismatches are written, to the default one
+    bool outputDirGiven = argc > 2;
+    filesystem::path regressionDir = outputDirGiven ? filesystem::path(argv[2]) : filesystem::temp_directory_path() / "parser27_regressions";
+
+    // Inputs of 1 KiB or more that take over 250 ns per byte, or any input
+    // over 50 ms, are reported as pathological. The reference combinators
+    // copy the remaining input at every step, so long chains show up here.
+    DifferentialHarness harness(regressionDir, 250.0, 50.0, outputDirGiven);
+    harness.replay();
+
+    InputGenerator generator(1234);
+    for (size_t i = 0; i < iterations; i++) {
+        harness.check(generator.next());
+    }
+
+    harness.report();
+    if (harness.savedCount() > 0) {
+        cout << harness.savedCount() << " regression cases written to " << regressionDir.string() << endl;
+    }
+    return harness.mismatchCount() == 0 ? 0 : 1;
+}
+#endif
@@ -0,0 +1,340 @@
+// how can the same grammar only check that input like x = 42 + y_2 is well formed, without building or allocating an AST, and report the offset where it failed?
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+// Count of AST node allocations, to show that validation builds no nodes.
+// Other heap use, such as std::string or std::function storage, is not counted.
+size_t allocations = 0;
+
+// Abstract syntax tree (AST) node classes. Nodes are counted through class
+// operator new, which leaves the global allocation functions alone.
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+
+    static void* operator new(size_t bytes) {
+        allocations++;
+        return ::operator new(bytes);
+    }
+    static void operator delete(void* memory, size_t bytes) {
+        ::operator delete(memory, bytes);
+    }
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Result policy that builds the AST
+struct BuildTree {
+    using Node = unique_ptr<ASTNode>;
+
+    static Node variable(string_view name) { return make_unique<VariableNode>(string(name)); }
+    static Node number(int value) { return make_unique<NumberNode>(value); }
+    static Node binary(char op, Node left, Node right) { return make_unique<BinaryOpNode>(op, move(left), move(right)); }
+    static Node assignment(Node left, Node right) { return make_unique<AssignmentNode>(move(left), move(right)); }
+};
+
+// Result policy that only recognizes: the node type is empty and every
+// constructor is a no-op, so nothing is allocated or copied
+struct RecognizeOnly {
+    struct Node {};
+
+    static Node variable(string_view) { return {}; }
+    static Node number(int) { return {}; }
+    static Node binary(char, Node, Node) { return {}; }
+    static Node assignment(Node, Node) { return {}; }
+};
+
+// Per-parse state: the furthest offset at which any rule failed, which is
+// where a human would look for the syntax error
+struct ParseState {
+    const char* begin;
+    const char* furthestFailure;
+
+    void fail(string_view input) {
+        furthestFailure = max(furthestFailure, input.data());
+    }
+    size_t failureOffset() const { return furthestFailure - begin; }
+};
+
+// Define a parser combinator function type for a result policy
+template<typename Policy>
+using Parser = function<optional<pair<typename Policy::Node, string_view>>(string_view, ParseState&)>;
+
+template<typename Policy>
+using Result = optional<pair<typename Policy::Node, string_view>>;
+
+// Skip leading whitespace
+string_view skipSpaces(string_view input) {
+    size_t pos = 0;
+    while (pos < input.size() && spaces.contains(static_cast<unsigned char>(input[pos]))) pos++;
+    return input.substr(pos);
+}
+
+// Parser combinator function to match a single character; it carries no value
+optional<string_view> matchChar(char c, string_view input, ParseState& state) {
+    input = skipSpaces(input);
+    if (!input.empty() && input[0] == c) return input.substr(1);
+    state.fail(input);
+    return nullopt;
+}
+
+// The grammar, written once and instantiated for each result policy. The
+// rules capture this, so a grammar stays where it was built.
+template<typename Policy>
+struct Grammar {
+    using Node = typename Policy::Node;
+
+    Grammar() = default;
+    Grammar(const Grammar&) = delete;
+    Grammar& operator=(const Grammar&) = delete;
+
+    // Parser for variable names
+    Parser<Policy> variableParser = [](string_view input, ParseState& state) -> Result<Policy> {
+        input = skipSpaces(input);
+        if (input.empty() || !letters.contains(static_cast<unsigned char>(input[0]))) {
+            state.fail(input);
+            return nullopt;
+        }
+        size_t pos = 1;
+        while (pos < input.size() && identifierChars.contains(static_cast<unsigned char>(input[pos]))) pos++;
+        return make_pair(Policy::variable(input.substr(0, pos)), input.substr(pos));
+    };
+
+    // Parser for numbers (sequence of digits); a literal that does not fit an
+    // int fails where it starts
+    Parser<Policy> numberParser = [](string_view input, ParseState& state) -> Result<Policy> {
+        input = skipSpaces(input);
+        size_t pos = 0;
+        while (pos < input.size() && digits.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        int value = 0;
+        if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+            state.fail(input);
+            return nullopt;
+        }
+        return make_pair(Policy::number(value), input.substr(pos));
+    };
+
+    // Parser for a term (number or variable)
+    Parser<Policy> termParser = [this](string_view input, ParseState& state) -> Result<Policy> {
+        if (auto result = numberParser(input, state); result) return result;
+        return variableParser(input, state);
+    };
+
+    // Parser for expressions: term ('+' term)*, folded to the left
+    Parser<Policy> expressionParser = [this](string_view input, ParseState& state) -> Result<Policy> {
+        auto result = termParser(input, state);
+        if (!result) return nullopt;
+        Node tree = move(result->first);
+        string_view remaining = result->second;
+        while (auto afterPlus = matchChar('+', remaining, state)) {
+            auto right = termParser(*afterPlus, state);
+            if (!right) break;
+            tree = Policy::binary('+', move(tree), move(right->first));
+            remaining = right->second;
+        }
+        return make_pair(move(tree), remaining);
+    };
+
+    // Parser for assignment (variable = expression)
+    Parser<Policy> assignmentParser = [this](string_view input, ParseState& state) -> Result<Policy> {
+        auto target = variableParser(input, state);
+        if (!target) return nullopt;
+        auto afterEquals = matchChar('=', target->second, state);
+        if (!afterEquals) return nullopt;
+        auto value = expressionParser(*afterEquals, state);
+        if (!value) return nullopt;
+        return make_pair(Policy::assignment(move(target->first), move(value->first)), value->second);
+    };
+
+    // Parse a whole input: one assignment and nothing but whitespace after it
+    Result<Policy> parseStatement(string_view input, ParseState& state) const {
+        auto result = assignmentParser(input, state);
+        if (!result) return nullopt;
+        string_view rest = skipSpaces(result->second);
+        if (!rest.empty()) {
+            state.fail(rest);
+            return nullopt;
+        }
+        return result;
+    }
+};
+
+// Outcome of validation: success, or the offset of the furthest failure
+struct Validation {
+    bool valid;
+    size_t failureOffset;
+};
+
+// Validation mode: the same grammar with the no-op policy
+Validation validate(const Grammar<RecognizeOnly>& grammar, string_view input) {
+    ParseState state{input.data(), input.data()};
+    bool valid = grammar.parseStatement(input, state).has_value();
+    return {valid, valid ? input.size() : state.failureOffset()};
+}
+
+// Full mode: the same grammar building the tree
+unique_ptr<ASTNode> parse(const Grammar<BuildTree>& grammar, string_view input) {
+    ParseState state{input.data(), input.data()};
+    auto result = grammar.parseStatement(input, state);
+    return result ? move(result->first) : nullptr;
+}
+
+// Test the parser
+int main() {
+    Grammar<RecognizeOnly> recognizer;
+    Grammar<BuildTree> builder;
+
+    for (string_view input : {"x = 42 + y_2", "x = 99999999999 + y", "x = 42 +", "x = + 1", "= 3", "total = a + b + 7 ;"}) {
+        Validation result = validate(recognizer, input);
+        cout << "\"" << input << "\": ";
+        if (result.valid) {
+            cout << "valid, ";
+            parse(builder, input)->print();
+        } else {
+            cout << "invalid at offset " << result.failureOffset;
+        }
+        cout << endl;
+    }
+
+    // Compare validation with full tree construction on many statements
+    vector<string> statements;
+    for (int i = 0; i < 200000; i++) {
+        statements.push_back("value_" + to_string(i) + " = " + to_string(i) + " + y_2 + offset + " + to_string(i % 10));
+    }
+
+    size_t before = allocations;
+    auto start = chrono::steady_clock::now();
+    size_t valid = 0;
+    for (const auto& statement : statements) {
+        valid += validate(recognizer, statement).valid;
+    }
+    auto validated = chrono::steady_clock::now();
+    size_t validationAllocations = allocations - before;
+
+    before = allocations;
+    size_t built = 0;
+    for (const auto& statement : statements) {
+        built += parse(builder, statement) != nullptr;
+    }
+    auto parsed = chrono::steady_clock::now();
+    size_t parseAllocations = allocations - before;
+
+    cout << "Validate: " << valid << " statements in " << chrono::duration_cast<chrono::milliseconds>(validated - start).count()
+         << " ms, " << validationAllocations << " AST node allocations" << endl;
+    cout << "Parse:    " << built << " statements in " << chrono::duration_cast<chrono::milliseconds>(parsed - validated).count()
+         << " ms, " << parseAllocations << " AST node allocations" << endl;
+
+    return 0;
+}
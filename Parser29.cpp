@@ -0,0 +1,568 @@
+// huge statement files are parsed only to look at assignment targets, yet every right hand side is built into BinaryOpNode trees; record the span of the right hand side with a fast bracket and terminator scan and build its subtree only when a caller first asks for it
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Count of node bytes allocated, to compare the memory cost of eager and lazy parsing
+size_t allocatedBytes = 0;
+
+// Abstract syntax tree (AST) node classes. Node bytes are counted through
+// class operator new, which leaves the global allocation functions alone.
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+
+    static void* operator new(size_t bytes) {
+        allocatedBytes += bytes;
+        return ::operator new(bytes);
+    }
+    static void operator delete(void* memory, size_t bytes) {
+        ::operator delete(memory, bytes);
+    }
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Result of a parser producing a T: the value and the remaining input
+template<typename T>
+using Result = optional<pair<T, string_view>>;
+
+// Define a parser combinator function type, generic over the result type.
+// The input is a view, so consuming characters never copies the rest of it.
+template<typename T>
+using Parser = function<Result<T>(string_view)>;
+
+// Value of rules that only recognize input
+struct Unit {};
+
+// Parser combinator function to parse a single character
+Parser<char> charParser(char c) {
+    return [c](string_view input) -> Result<char> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(c, input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Parser combinator function to parse any character of a set
+Parser<char> charSetParser(CharSet set) {
+    return [set](string_view input) -> Result<char> {
+        if (!input.empty() && set.contains(static_cast<unsigned char>(input[0]))) {
+            return make_pair(input[0], input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Map combinator: transform the value of a successful parse
+template<typename T, typename F>
+auto mapParser(Parser<T> parser, F f) -> Parser<decltype(f(declval<T>()))> {
+    using U = decltype(f(declval<T>()));
+    return [parser, f](string_view input) -> Result<U> {
+        if (auto result = parser(input); result) {
+            return make_pair(f(move(result->first)), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Sequence combinator: run the parsers one after another and collect their values in a tuple
+template<typename T, typename... Ts>
+Parser<tuple<T, Ts...>> seqParser(Parser<T> first, Parser<Ts>... rest) {
+    if constexpr (sizeof...(Ts) == 0) {
+        return mapParser(first, [](T value) { return tuple<T>(move(value)); });
+    } else {
+        Parser<tuple<Ts...>> others = seqParser(rest...);
+        return [first, others](string_view input) -> Result<tuple<T, Ts...>> {
+            auto firstResult = first(input);
+            if (!firstResult) return nullopt;
+
+            auto othersResult = others(firstResult->second);
+            if (!othersResult) return nullopt;
+
+            return make_pair(tuple_cat(tuple<T>(move(firstResult->first)), move(othersResult->first)),
+                             othersResult->second);
+        };
+    }
+}
+
+// OR combinator to combine multiple parsers of the same result type
+template<typename T, typename... Parsers>
+Parser<T> orParser(Parser<T> first, Parsers... rest) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser<T>> parserList = {first, rest...};
+    return [parserList](string_view input) -> Result<T> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Skip combinator: run the parser and drop its value
+template<typename T>
+Parser<Unit> skipParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        if (auto result = parser(input); result) {
+            return make_pair(Unit{}, result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Skip zero or more repetitions of a parser without collecting anything
+template<typename T>
+Parser<Unit> skipManyParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        while (auto result = parser(input)) {
+            if (result->second.size() == input.size()) break;
+            input = result->second;
+        }
+        return make_pair(Unit{}, input);
+    };
+}
+
+// Run ignored first, then parser, keeping only the value of parser
+template<typename T, typename U>
+Parser<U> ignoreThen(Parser<T> ignored, Parser<U> parser) {
+    return [ignored, parser](string_view input) -> Result<U> {
+        auto ignoredResult = ignored(input);
+        if (!ignoredResult) return nullopt;
+        return parser(ignoredResult->second);
+    };
+}
+
+// Span combinator: the value is the text the parser consumed, not whatever it built
+template<typename T>
+Parser<string_view> spanParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<string_view> {
+        if (auto result = parser(input); result) {
+            size_t length = input.size() - result->second.size();
+            return make_pair(input.substr(0, length), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+template<typename T>
+Parser<T> lexeme(Parser<T> parser) {
+    return ignoreThen(skipManyParser(charSetParser(spaces)), parser);
+}
+
+// Chain combinator for left recursive rules: operand (op operand)*, folded with combine
+template<typename T, typename F>
+Parser<T> chainLeftParser(Parser<T> operand, Parser<char> op, F combine) {
+    return [operand, op, combine](string_view input) -> Result<T> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        T value = move(result->first);
+        string_view remaining = result->second;
+        while (auto opResult = op(remaining)) {
+            auto operandResult = operand(opResult->second);
+            if (!operandResult) break;
+            value = combine(opResult->first, move(value), move(operandResult->first));
+            remaining = operandResult->second;
+        }
+        return make_pair(move(value), remaining);
+    };
+}
+
+// Run parser, then ignored, keeping only the value of parser
+template<typename T, typename U>
+Parser<T> thenIgnore(Parser<T> parser, Parser<U> ignored) {
+    return [parser, ignored](string_view input) -> Result<T> {
+        auto result = parser(input);
+        if (!result) return nullopt;
+        auto ignoredResult = ignored(result->second);
+        if (!ignoredResult) return nullopt;
+        return make_pair(move(result->first), ignoredResult->second);
+    };
+}
+
+// Take the longest prefix of characters in a set. The value is a span of the
+// input, so no container is involved at all.
+Parser<string_view> takeWhileParser(CharSet set, size_t minimum = 0) {
+    return [set, minimum](string_view input) -> Result<string_view> {
+        size_t length = 0;
+        while (length < input.size() && set.contains(static_cast<unsigned char>(input[length]))) {
+            length++;
+        }
+        if (length < minimum) return nullopt;
+        return make_pair(input.substr(0, length), input.substr(length));
+    };
+}
+
+
+// Character level rules: they return plain chars and spans and allocate nothing per call
+Parser<string_view> identifierParser =
+    spanParser(seqParser(charSetParser(letters), skipManyParser(charSetParser(identifierChars))));
+Parser<string_view> digitsParser = takeWhileParser(digits, 1);
+
+// Node level rules: only these construct AST nodes
+using Node = unique_ptr<ASTNode>;
+
+Parser<Node> variableParser = mapParser(identifierParser, [](string_view name) -> Node {
+    return make_unique<VariableNode>(string(name));
+});
+
+// A literal that does not fit an int fails the parse
+Parser<Node> numberParser = [](string_view input) -> Result<Node> {
+    auto digitsResult = digitsParser(input);
+    if (!digitsResult) return nullopt;
+    string_view text = digitsResult->first;
+    int value = 0;
+    if (from_chars(text.data(), text.data() + text.size(), value).ec != errc()) return nullopt;
+    return make_pair(make_unique<NumberNode>(value), digitsResult->second);
+};
+
+// Defined below; a parenthesized term refers back to it
+extern Parser<Node> expressionParser;
+
+// Parser for a term (number, variable or parenthesized expression)
+Parser<Node> termParser = lexeme(orParser(
+    numberParser,
+    variableParser,
+    ignoreThen(charParser('('), thenIgnore(Parser<Node>([](string_view input) { return expressionParser(input); }),
+                                           lexeme(charParser(')'))))));
+
+// Parser for expressions: expr := expr '+' term | term
+Parser<Node> expressionParser = chainLeftParser(termParser, lexeme(charParser('+')), [](char op, Node left, Node right) -> Node {
+    return make_unique<BinaryOpNode>(op, move(left), move(right));
+});
+
+// Skip whitespace, including newlines between statements
+string_view skipSpaces(string_view input) {
+    size_t pos = 0;
+    while (pos < input.size() && spaces.contains(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    return input.substr(pos);
+}
+
+// Parse a complete right hand side: the expression must cover the whole span
+Node parseExpression(string_view source) {
+    auto result = expressionParser(source);
+    if (!result || !skipSpaces(result->second).empty()) return nullptr;
+    return move(result->first);
+}
+
+// Right hand side that has been scanned but not parsed. The subtree is built
+// on first access; the source text must outlive the node. The cache is filled
+// without synchronization, so a node must only be accessed from one thread.
+class LazyExpressionNode : public ASTNode {
+public:
+    string_view source;
+    LazyExpressionNode(string_view source) : source(source) {}
+
+    // Build the subtree if needed; nullptr if the span is not a valid expression
+    const ASTNode* get() const {
+        if (!parsed) {
+            tree = parseExpression(source);
+            parsed = true;
+        }
+        return tree.get();
+    }
+
+    bool materialized() const {
+        return parsed;
+    }
+
+    void print() const override {
+        if (const ASTNode* node = get()) {
+            node->print();
+        } else {
+            cout << "Invalid(" << source << ")";
+        }
+    }
+
+private:
+    mutable unique_ptr<ASTNode> tree;
+    mutable bool parsed = false;
+};
+
+// Characters the span scan has to stop at. Newlines are whitespace inside an
+// expression, exactly as for the eager rule, so they are not among them.
+constexpr CharSet scanStops = CharSet('(') | ')' | ';';
+
+// Fast scan of a right hand side: everything up to a ';' outside brackets or
+// the end of the input, with trailing whitespace trimmed. Brackets must balance, but the
+// tokens in between are not looked at until the subtree is built.
+Parser<string_view> expressionSpanParser = [](string_view input) -> Result<string_view> {
+    size_t begin = 0;
+    while (begin < input.size() && spaces.contains(static_cast<unsigned char>(input[begin]))) {
+        begin++;
+    }
+
+    size_t pos = begin;
+    size_t depth = 0;
+    for (; pos < input.size(); pos++) {
+        unsigned char c = static_cast<unsigned char>(input[pos]);
+        if (!scanStops.contains(c)) continue;
+        if (c == '(') {
+            depth++;
+        } else if (c == ')') {
+            if (depth == 0) return nullopt;
+            depth--;
+        } else if (depth == 0) {
+            break;
+        }
+    }
+    if (depth != 0) return nullopt;
+
+    size_t end = pos;
+    while (end > begin && spaces.contains(static_cast<unsigned char>(input[end - 1]))) {
+        end--;
+    }
+    if (end == begin) return nullopt;
+    return make_pair(input.substr(begin, end - begin), input.substr(pos));
+};
+
+// Parser for assignment (variable = expression), building the whole tree
+Parser<Node> assignmentParser = mapParser(
+    seqParser(lexeme(variableParser), skipParser(lexeme(charParser('='))), expressionParser),
+    [](tuple<Node, Unit, Node> parts) -> Node {
+        return make_unique<AssignmentNode>(move(get<0>(parts)), move(get<2>(parts)));
+    });
+
+// Parser for assignment (variable = expression) with a lazy right hand side
+Parser<Node> lazyAssignmentParser = mapParser(
+    seqParser(lexeme(variableParser), skipParser(lexeme(charParser('='))), expressionSpanParser),
+    [](tuple<Node, Unit, string_view> parts) -> Node {
+        return make_unique<AssignmentNode>(move(get<0>(parts)), make_unique<LazyExpressionNode>(get<2>(parts)));
+    });
+
+// A statement ends at ';'; both rules see newlines as plain whitespace
+Parser<char> terminatorParser = ignoreThen(takeWhileParser(spaces), charParser(';'));
+
+// Parse a program of statements with the given assignment rule. A statement
+// that fails is skipped up to its terminator.
+vector<Node> parseProgram(const Parser<Node>& assignment, string_view input, size_t& errors) {
+    vector<Node> statements;
+    while (!(input = skipSpaces(input)).empty()) {
+        auto result = assignment(input);
+        if (result) {
+            // The last statement may end at the end of the input instead
+            if (auto terminator = terminatorParser(result->second)) {
+                result->second = terminator->second;
+            } else if (!skipSpaces(result->second).empty()) {
+                result = nullopt;
+            }
+        }
+        if (!result) {
+            errors++;
+            size_t end = input.find(';');
+            input = end == string_view::npos ? string_view() : input.substr(end + 1);
+            continue;
+        }
+        statements.push_back(move(result->first));
+        input = result->second;
+    }
+    return statements;
+}
+
+// Render a tree the way print does, for comparing the two modes
+string printed(const ASTNode& node) {
+    ostringstream text;
+    streambuf* previous = cout.rdbuf(text.rdbuf());
+    node.print();
+    cout.rdbuf(previous);
+    return text.str();
+}
+
+// Test the parser
+int main(int argc, char* argv[]) {
+    string input = "x = 42 + (y_2 + 7);\ntotal = (a + b) + ((c));\nbroken = 1 + + 2;";
+
+    // Expressions may span lines; both modes must split the program the same way
+    string multiLine = "x = 1\n  + (y +\n 2)\n  + z;\ny = (a\n+ b);\nbroken = 1 +\n+ 2;\nlast = x\n+ y";
+    size_t eagerCheckErrors = 0, lazyCheckErrors = 0;
+    vector<Node> eagerCheck = parseProgram(assignmentParser, multiLine, eagerCheckErrors);
+    vector<Node> lazyCheck = parseProgram(lazyAssignmentParser, multiLine, lazyCheckErrors);
+    // The lazy rule only reports a bad right hand side once it is built
+    for (auto it = lazyCheck.begin(); it != lazyCheck.end();) {
+        if (static_cast<const LazyExpressionNode*>(static_cast<const AssignmentNode*>(it->get())->right.get())->get()) {
+            ++it;
+        } else {
+            it = lazyCheck.erase(it);
+            lazyCheckErrors++;
+        }
+    }
+    bool agree = eagerCheck.size() == lazyCheck.size() && eagerCheckErrors == lazyCheckErrors;
+    for (size_t i = 0; agree && i < eagerCheck.size(); i++) {
+        agree = printed(*eagerCheck[i]) == printed(*lazyCheck[i]);
+    }
+    cout << "Multi-line program: " << eagerCheck.size() << " statements, " << eagerCheckErrors << " errors, modes "
+         << (agree ? "agree" : "DISAGREE") << endl;
+    if (!agree) return 1;
+
+    size_t errors = 0;
+    vector<Node> statements = parseProgram(lazyAssignmentParser, input, errors);
+    for (const auto& statement : statements) {
+        const auto* assignment = static_cast<const AssignmentNode*>(statement.get());
+        const auto* value = static_cast<const LazyExpressionNode*>(assignment->right.get());
+        cout << "Target ";
+        assignment->left->print();
+        cout << ", right hand side \"" << value->source << "\" materialized: " << value->materialized() << endl;
+        cout << "Parsed: ";
+        statement->print();
+        cout << endl;
+    }
+
+    // Many statements of which the caller only reads the targets and a few values
+    size_t count = argc > 1 ? stoul(argv[1]) : 100000;
+    string program;
+    for (size_t i = 0; i < count; i++) {
+        program += "value_" + to_string(i) + " = (a + " + to_string(i) + ") + (b + (c + 7)) + offset + " + to_string(i % 10) + ";\n";
+    }
+
+    size_t before = allocatedBytes;
+    auto start = chrono::steady_clock::now();
+    size_t eagerErrors = 0;
+    vector<Node> eager = parseProgram(assignmentParser, program, eagerErrors);
+    auto eagerDone = chrono::steady_clock::now();
+    size_t eagerBytes = allocatedBytes - before;
+
+    before = allocatedBytes;
+    size_t lazyErrors = 0;
+    vector<Node> lazy = parseProgram(lazyAssignmentParser, program, lazyErrors);
+    size_t targets = 0;
+    for (const auto& statement : lazy) {
+        targets += !static_cast<const VariableNode*>(static_cast<const AssignmentNode*>(statement.get())->left.get())->name.empty();
+    }
+    auto lazyDone = chrono::steady_clock::now();
+    size_t lazyBytes = allocatedBytes - before;
+
+    // Touch one right hand side in a hundred
+    size_t built = 0;
+    for (size_t i = 0; i < lazy.size(); i += 100) {
+        built += static_cast<const LazyExpressionNode*>(static_cast<const AssignmentNode*>(lazy[i].get())->right.get())->get() != nullptr;
+    }
+    auto touchDone = chrono::steady_clock::now();
+
+    cout << "Eager: " << eager.size() << " statements in " << chrono::duration_cast<chrono::milliseconds>(eagerDone - start).count()
+         << " ms, " << eagerBytes / 1024 << " KiB of nodes, " << eagerErrors << " errors" << endl;
+    cout << "Lazy:  " << targets << " targets in " << chrono::duration_cast<chrono::milliseconds>(lazyDone - eagerDone).count()
+         << " ms, " << lazyBytes / 1024 << " KiB of nodes, " << lazyErrors << " errors" << endl;
+    cout << "Lazy:  " << built << " right hand sides built on access in "
+         << chrono::duration_cast<chrono::milliseconds>(touchDone - lazyDone).count() << " ms" << endl;
+
+    return 0;
+}
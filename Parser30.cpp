@@ -0,0 +1,584 @@
+// main reads, tokenizes, parses and evaluates on one thread in one loop; split x = 42 + y_2 ingestion into read, lex, parse and evaluate stages on separate threads connected by bounded lock-free single producer single consumer ring buffers of token and statement batches
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+
+// Character classes used by the lexer
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Bounded lock-free ring buffer for exactly one producer and one consumer
+// thread. Each side caches the other's index so that it only touches the
+// shared cache line when the ring looks full or empty.
+template<typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side; false if the ring is full, in which case item is untouched
+    bool tryPush(T& item) {
+        size_t position = tail.load(memory_order_relaxed);
+        if (position - cachedHead == Capacity) {
+            cachedHead = head.load(memory_order_acquire);
+            if (position - cachedHead == Capacity) return false;
+        }
+        slots[position & (Capacity - 1)] = move(item);
+        tail.store(position + 1, memory_order_release);
+        tail.notify_one();
+        return true;
+    }
+
+    // Consumer side; false if the ring is empty
+    bool tryPop(T& item) {
+        size_t position = head.load(memory_order_relaxed);
+        if (position == cachedTail) {
+            cachedTail = tail.load(memory_order_acquire);
+            if (position == cachedTail) return false;
+        }
+        item = move(slots[position & (Capacity - 1)]);
+        head.store(position + 1, memory_order_release);
+        head.notify_one();
+        return true;
+    }
+
+    // Producer side: sleep until the consumer frees a slot
+    void waitForSpace() {
+        size_t position = tail.load(memory_order_relaxed);
+        size_t observed = head.load(memory_order_acquire);
+        if (position - observed == Capacity) head.wait(observed, memory_order_acquire);
+    }
+
+    // Consumer side: sleep until the producer publishes an item
+    void waitForItem() {
+        size_t position = head.load(memory_order_relaxed);
+        size_t observed = tail.load(memory_order_acquire);
+        if (position == observed) tail.wait(observed, memory_order_acquire);
+    }
+
+private:
+    array<T, Capacity> slots;
+    alignas(64) atomic<size_t> head{0};
+    size_t cachedTail = 0;
+    alignas(64) atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+};
+
+// Per-stage counters. They are written by the stage's own thread only and,
+// being atomics, can be read by a monitor at any time.
+struct StageStats {
+    atomic<uint64_t> batches{0};
+    atomic<uint64_t> items{0};
+    atomic<uint64_t> inputWaits{0};   // times the stage found its input ring empty
+    atomic<uint64_t> outputWaits{0};  // times backpressure blocked it on a full output ring
+    atomic<double> busySeconds{0};    // time spent on work, excluding waits
+};
+
+// Spins before a waiting stage goes to sleep. A short wait is cheaper to spin
+// through than to sleep and be woken from; a long one must not burn a core.
+constexpr unsigned spinLimit = 64;
+
+// Blocking push: waits while the consumer is behind, which is the backpressure
+template<typename T, size_t Capacity>
+void pushBatch(SpscRing<T, Capacity>& ring, T& batch, StageStats& stats) {
+    if (ring.tryPush(batch)) return;
+    stats.outputWaits.fetch_add(1, memory_order_relaxed);
+    for (unsigned spins = 0; !ring.tryPush(batch);) {
+        if (++spins >= spinLimit) ring.waitForSpace();
+    }
+}
+
+// Blocking pop
+template<typename T, size_t Capacity>
+void popBatch(SpscRing<T, Capacity>& ring, T& batch, StageStats& stats) {
+    if (ring.tryPop(batch)) return;
+    stats.inputWaits.fetch_add(1, memory_order_relaxed);
+    for (unsigned spins = 0; !ring.tryPop(batch);) {
+        if (++spins >= spinLimit) ring.waitForItem();
+    }
+}
+
+// Read stage output: a block of text that ends on a statement boundary
+struct TextBatch {
+    string text;
+    bool last = false;
+};
+
+enum class TokenKind : uint8_t {
+    Name,
+    Number,
+    Plus,
+    Equals,
+    Semicolon,
+    Invalid
+};
+
+// A token is a kind and a span of the batch text, so lexing copies nothing
+struct Token {
+    TokenKind kind;
+    uint32_t offset;
+    uint32_t length;
+};
+
+// Lex stage output: the text and its tokens travel together
+struct TokenBatch {
+    string text;
+    vector<Token> tokens;
+    bool last = false;
+};
+
+// Parse stage output: one AssignmentNode per statement
+struct StatementBatch {
+    vector<unique_ptr<ASTNode>> statements;
+    uint64_t errors = 0;
+    bool last = false;
+};
+
+// Read stage: cut the stream into blocks of about chunkSize bytes. The tail
+// after the last ';' is carried into the next block so no statement is split.
+class BlockReader {
+public:
+    BlockReader(istream& in, size_t chunkSize) : in(in), chunkSize(chunkSize) {}
+
+    // The batch with last set is the final one and may be empty
+    TextBatch next() {
+        TextBatch batch;
+        batch.text = move(carry);
+        carry.clear();
+        while (true) {
+            size_t size = batch.text.size();
+            batch.text.resize(size + chunkSize);
+            in.read(batch.text.data() + size, chunkSize);
+            batch.text.resize(size + in.gcount());
+            if (!in) {
+                batch.last = true;
+                return batch;
+            }
+            size_t end = batch.text.rfind(';');
+            if (end != string::npos) {
+                carry.assign(batch.text, end + 1);
+                batch.text.resize(end + 1);
+                return batch;
+            }
+        }
+    }
+
+private:
+    istream& in;
+    size_t chunkSize;
+    string carry;
+};
+
+// Lex stage: turn a block of text into tokens
+void lexBatch(const string& text, vector<Token>& tokens) {
+    tokens.clear();
+    size_t pos = 0;
+    while (pos < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[pos]);
+        size_t start = pos;
+        TokenKind kind;
+        if (spaces.contains(c)) {
+            pos++;
+            continue;
+        } else if (letters.contains(c)) {
+            while (++pos < text.size() && identifierChars.contains(static_cast<unsigned char>(text[pos]))) {
+            }
+            kind = TokenKind::Name;
+        } else if (digits.contains(c)) {
+            while (++pos < text.size() && digits.contains(static_cast<unsigned char>(text[pos]))) {
+            }
+            kind = TokenKind::Number;
+        } else {
+            pos++;
+            kind = c == '+' ? TokenKind::Plus : c == '=' ? TokenKind::Equals : c == ';' ? TokenKind::Semicolon : TokenKind::Invalid;
+        }
+        tokens.push_back(Token{kind, static_cast<uint32_t>(start), static_cast<uint32_t>(pos - start)});
+    }
+}
+
+// Parse stage: statement := name '=' term ('+' term)* ';' over tokens. A
+// statement with an error is skipped up to its ';' and counted.
+void parseBatch(const TokenBatch& input, StatementBatch& output) {
+    const vector<Token>& tokens = input.tokens;
+    auto text = [&](const Token& token) { return string_view(input.text).substr(token.offset, token.length); };
+    auto term = [&](size_t& i) -> unique_ptr<ASTNode> {
+        if (i >= tokens.size()) return nullptr;
+        const Token& token = tokens[i];
+        if (token.kind == TokenKind::Name) {
+            i++;
+            return make_unique<VariableNode>(string(text(token)));
+        }
+        if (token.kind == TokenKind::Number) {
+            int value = 0;
+            string_view digits = text(token);
+            auto [end, error] = from_chars(digits.data(), digits.data() + digits.size(), value);
+            if (error != errc()) return nullptr;
+            i++;
+            return make_unique<NumberNode>(value);
+        }
+        return nullptr;
+    };
+
+    size_t i = 0;
+    while (i < tokens.size()) {
+        size_t start = i;
+        unique_ptr<ASTNode> statement;
+        if (i + 1 < tokens.size() && tokens[i].kind == TokenKind::Name && tokens[i + 1].kind == TokenKind::Equals) {
+            auto target = make_unique<VariableNode>(string(text(tokens[i])));
+            i += 2;
+            unique_ptr<ASTNode> expression = term(i);
+            while (expression && i < tokens.size() && tokens[i].kind == TokenKind::Plus) {
+                i++;
+                unique_ptr<ASTNode> right = term(i);
+                expression = right ? make_unique<BinaryOpNode>('+', move(expression), move(right)) : nullptr;
+            }
+            if (expression && i < tokens.size() && tokens[i].kind == TokenKind::Semicolon) {
+                statement = make_unique<AssignmentNode>(move(target), move(expression));
+                i++;
+            }
+        }
+        if (statement) {
+            output.statements.push_back(move(statement));
+            continue;
+        }
+        output.errors++;
+        i = start;
+        while (i < tokens.size() && tokens[i].kind != TokenKind::Semicolon) {
+            i++;
+        }
+        i++;
+    }
+}
+
+// Evaluate stage: assignments run in order; a variable never assigned is 0
+class Evaluator {
+public:
+    void evaluate(const ASTNode& statement) {
+        const auto& assignment = static_cast<const AssignmentNode&>(statement);
+        // Expressions are left deep chains of '+', so walk the left spine
+        uint64_t value = 0;
+        const ASTNode* node = assignment.right.get();
+        while (auto binary = dynamic_cast<const BinaryOpNode*>(node)) {
+            value += termValue(*binary->right);
+            node = binary->left.get();
+        }
+        value += termValue(*node);
+        values[static_cast<const VariableNode&>(*assignment.left).name] = value;
+        checksum = checksum * 31 + value;
+        evaluated++;
+    }
+
+    uint64_t evaluated = 0;
+    uint64_t checksum = 0;
+
+private:
+    uint64_t termValue(const ASTNode& node) const {
+        if (auto number = dynamic_cast<const NumberNode*>(&node)) return static_cast<uint64_t>(number->value);
+        auto it = values.find(static_cast<const VariableNode&>(node).name);
+        return it == values.end() ? 0 : it->second;
+    }
+
+    unordered_map<string, uint64_t> values;
+};
+
+// Totals of one run
+struct RunResult {
+    uint64_t statements = 0;
+    uint64_t errors = 0;
+    uint64_t checksum = 0;
+    double seconds = 0;
+};
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// The four stages on four threads. Rings hold a few batches each, so a slow
+// stage makes the stages before it wait instead of buffering without bound.
+class Pipeline {
+public:
+    static constexpr size_t ringCapacity = 8;
+
+    Pipeline(istream& in, size_t chunkSize) : reader(in, chunkSize) {}
+
+    RunResult run() {
+        auto start = chrono::steady_clock::now();
+        thread readThread([this] { readStage(); });
+        thread lexThread([this] { lexStage(); });
+        thread parseThread([this] { parseStage(); });
+        evaluateStage();
+        readThread.join();
+        lexThread.join();
+        parseThread.join();
+        result.seconds = secondsSince(start);
+        return result;
+    }
+
+    void report(uint64_t bytes) const {
+        const char* names[] = {"read", "lex", "parse", "evaluate"};
+        const StageStats* stages[] = {&readStats, &lexStats, &parseStats, &evaluateStats};
+        for (size_t i = 0; i < 4; i++) {
+            const StageStats& stats = *stages[i];
+            cout << "  " << names[i] << ": " << stats.batches << " batches, " << stats.items << " items, "
+                 << static_cast<uint64_t>(stats.items.load(memory_order_relaxed) / stats.busySeconds.load(memory_order_relaxed)) << " items/s busy, " << stats.inputWaits
+                 << " input waits, " << stats.outputWaits << " output waits" << endl;
+        }
+        cout << "  throughput: " << static_cast<uint64_t>(bytes / result.seconds / (1 << 20)) << " MiB/s" << endl;
+    }
+
+private:
+    void readStage() {
+        bool last = false;
+        while (!last) {
+            auto start = chrono::steady_clock::now();
+            TextBatch batch = reader.next();
+            readStats.busySeconds.fetch_add(secondsSince(start), memory_order_relaxed);
+            last = batch.last;
+            readStats.batches.fetch_add(1, memory_order_relaxed);
+            readStats.items.fetch_add(batch.text.size(), memory_order_relaxed);
+            pushBatch(texts, batch, readStats);
+        }
+    }
+
+    void lexStage() {
+        TextBatch input;
+        do {
+            popBatch(texts, input, lexStats);
+            auto start = chrono::steady_clock::now();
+            TokenBatch output;
+            output.text = move(input.text);
+            output.last = input.last;
+            lexBatch(output.text, output.tokens);
+            lexStats.busySeconds.fetch_add(secondsSince(start), memory_order_relaxed);
+            lexStats.batches.fetch_add(1, memory_order_relaxed);
+            lexStats.items.fetch_add(output.tokens.size(), memory_order_relaxed);
+            pushBatch(tokens, output, lexStats);
+        } while (!input.last);
+    }
+
+    void parseStage() {
+        TokenBatch input;
+        do {
+            popBatch(tokens, input, parseStats);
+            auto start = chrono::steady_clock::now();
+            StatementBatch output;
+            output.last = input.last;
+            parseBatch(input, output);
+            parseStats.busySeconds.fetch_add(secondsSince(start), memory_order_relaxed);
+            parseStats.batches.fetch_add(1, memory_order_relaxed);
+            parseStats.items.fetch_add(output.statements.size(), memory_order_relaxed);
+            pushBatch(statements, output, parseStats);
+        } while (!input.last);
+    }
+
+    void evaluateStage() {
+        Evaluator evaluator;
+        StatementBatch input;
+        do {
+            popBatch(statements, input, evaluateStats);
+            auto start = chrono::steady_clock::now();
+            for (const auto& statement : input.statements) {
+                evaluator.evaluate(*statement);
+            }
+            evaluateStats.busySeconds.fetch_add(secondsSince(start), memory_order_relaxed);
+            result.errors += input.errors;
+            evaluateStats.batches.fetch_add(1, memory_order_relaxed);
+            evaluateStats.items.fetch_add(input.statements.size(), memory_order_relaxed);
+        } while (!input.last);
+        result.statements = evaluator.evaluated;
+        result.checksum = evaluator.checksum;
+    }
+
+    BlockReader reader;
+    SpscRing<TextBatch, ringCapacity> texts;
+    SpscRing<TokenBatch, ringCapacity> tokens;
+    SpscRing<StatementBatch, ringCapacity> statements;
+    StageStats readStats, lexStats, parseStats, evaluateStats;
+    RunResult result;
+};
+
+// The same stages called one after another on a single thread
+RunResult runSequential(istream& in, size_t chunkSize) {
+    auto start = chrono::steady_clock::now();
+    BlockReader reader(in, chunkSize);
+    Evaluator evaluator;
+    RunResult result;
+    TokenBatch tokens;
+    bool last = false;
+    while (!last) {
+        TextBatch text = reader.next();
+        last = text.last;
+        tokens.text = move(text.text);
+        lexBatch(tokens.text, tokens.tokens);
+        StatementBatch statements;
+        parseBatch(tokens, statements);
+        for (const auto& statement : statements.statements) {
+            evaluator.evaluate(*statement);
+        }
+        result.errors += statements.errors;
+    }
+    result.statements = evaluator.evaluated;
+    result.checksum = evaluator.checksum;
+    result.seconds = secondsSince(start);
+    return result;
+}
+
+// Test the pipeline on the files given as arguments, or on a generated program
+int main(int argc, char* argv[]) {
+    const size_t chunkSize = 64 * 1024;
+
+    string program;
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            ifstream file(argv[i], ios::binary);
+            if (!file) {
+                cerr << "Cannot open " << argv[i] << endl;
+                return 1;
+            }
+            program.append(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        }
+    } else {
+        for (int i = 0; i < 400000; i++) {
+            program += "v" + to_string(i) + " = " + to_string(i % 1000) + " + v" + to_string(i / 2) + " + y_2 + 7;\n";
+            if (i % 10000 == 0) {
+                program += "broken = 1 + ;\n";
+            }
+        }
+        program += "x = 42 + y_2";  // no terminator: an error at the end of the stream
+    }
+
+    istringstream sequentialInput(program);
+    RunResult sequential = runSequential(sequentialInput, chunkSize);
+    cout << "Sequential: " << sequential.statements << " statements, " << sequential.errors << " errors in "
+         << static_cast<uint64_t>(sequential.seconds * 1000) << " ms" << endl;
+
+    istringstream pipelineInput(program);
+    Pipeline pipeline(pipelineInput, chunkSize);
+    RunResult pipelined = pipeline.run();
+    cout << "Pipelined:  " << pipelined.statements << " statements, " << pipelined.errors << " errors in "
+         << static_cast<uint64_t>(pipelined.seconds * 1000) << " ms" << endl;
+    pipeline.report(program.size());
+
+    if (pipelined.checksum != sequential.checksum) {
+        cout << "Checksum mismatch between sequential and pipelined runs" << endl;
+        return 1;
+    }
+    return 0;
+}
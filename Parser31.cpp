@@ -0,0 +1,487 @@
+// orParser backtracking and the byte by byte skip loop in main can take exponential or quadratic time on hostile input and stall a worker; give every parse a context with a step budget and a deadline that the combinators check cheaply, and abort with a distinct timeout result
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Why a parse was stopped early
+enum class Limit : uint8_t {
+    None,
+    Steps,
+    Deadline,
+    Depth
+};
+
+// Per-parse budget. Every combinator call counts one step; the clock is only
+// read every checkInterval steps, so the check costs an increment and a
+// compare on the hot path. Recursive rules also count nesting depth, which
+// bounds the native stack a request can use. Once a limit is hit the parse
+// stays expired and every combinator fails immediately, unwinding the whole
+// parse.
+class ParseContext {
+public:
+    static constexpr uint64_t checkInterval = 1024;
+
+    ParseContext(uint64_t maxSteps, chrono::steady_clock::duration timeLimit, uint32_t maxDepth)
+        : maxSteps(maxSteps), maxDepth(maxDepth), start(chrono::steady_clock::now()), deadline(start + timeLimit) {}
+
+    // Count one step; false once the parse has run out of budget
+    bool step() {
+        if (limit != Limit::None) return false;
+        if (++steps >= nextCheck) {
+            if (steps >= maxSteps) {
+                limit = Limit::Steps;
+                return false;
+            }
+            if (chrono::steady_clock::now() >= deadline) {
+                limit = Limit::Deadline;
+                return false;
+            }
+            nextCheck = min(steps + checkInterval, maxSteps);
+        }
+        return true;
+    }
+
+    // Enter one level of a recursive rule; false once nesting is too deep.
+    // Every successful enter must be paired with a leave.
+    bool enter() {
+        if (limit != Limit::None) return false;
+        if (depth == maxDepth) {
+            limit = Limit::Depth;
+            return false;
+        }
+        depth++;
+        return true;
+    }
+
+    void leave() {
+        depth--;
+    }
+
+    bool expired() const {
+        return limit != Limit::None;
+    }
+
+    Limit reason() const {
+        return limit;
+    }
+
+    uint64_t stepsTaken() const {
+        return steps;
+    }
+
+    chrono::microseconds elapsed() const {
+        return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+    }
+
+private:
+    uint64_t steps = 0;
+    uint64_t maxSteps;
+    uint64_t nextCheck = 0;
+    uint32_t depth = 0;
+    uint32_t maxDepth;
+    chrono::steady_clock::time_point start;
+    chrono::steady_clock::time_point deadline;
+    Limit limit = Limit::None;
+};
+
+// One level of nesting for as long as the guard lives
+class DepthGuard {
+public:
+    explicit DepthGuard(ParseContext& context) : context(context), entered(context.enter()) {}
+    ~DepthGuard() {
+        if (entered) context.leave();
+    }
+    DepthGuard(const DepthGuard&) = delete;
+    DepthGuard& operator=(const DepthGuard&) = delete;
+
+    explicit operator bool() const {
+        return entered;
+    }
+
+private:
+    ParseContext& context;
+    bool entered;
+};
+
+// Define a parser combinator function type; every parser gets the context
+using Node = unique_ptr<ASTNode>;
+using Result = optional<pair<Node, string_view>>;
+using Parser = function<Result(string_view, ParseContext&)>;
+
+// Parser combinator function to parse a single character
+Parser charParser(char c) {
+    return [c](string_view input, ParseContext& context) -> Result {
+        if (!context.step()) return nullopt;
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        }
+        return nullopt;
+    };
+}
+
+// OR combinator to combine multiple parsers. It stops trying alternatives as
+// soon as the context has expired, which is what bounds backtracking.
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    vector<Parser> parserList = {parsers...};
+    return [parserList](string_view input, ParseContext& context) -> Result {
+        for (const auto& parser : parserList) {
+            if (!context.step()) return nullopt;
+            if (auto result = parser(input, context); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+Parser lexeme(Parser parser) {
+    return [parser](string_view input, ParseContext& context) -> Result {
+        if (!context.step()) return nullopt;
+        size_t pos = 0;
+        while (pos < input.size() && spaces.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return parser(input.substr(pos), context);
+    };
+}
+
+// Parser for variable names
+Parser variableParser = [](string_view input, ParseContext& context) -> Result {
+    if (!context.step()) return nullopt;
+    if (input.empty() || !letters.contains(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+    size_t pos = 1;
+    while (pos < input.size() && identifierChars.contains(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    return make_pair(make_unique<VariableNode>(string(input.substr(0, pos))), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits); values that do not fit an int fail
+Parser numberParser = [](string_view input, ParseContext& context) -> Result {
+    if (!context.step()) return nullopt;
+    size_t pos = 0;
+    while (pos < input.size() && digits.contains(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    int value = 0;
+    if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+        return nullopt;
+    }
+    return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+};
+
+// Token rules shared by the rules below, built once
+Parser openParser = charParser('(');
+Parser closeParser = lexeme(charParser(')'));
+Parser plusParser = lexeme(charParser('+'));
+Parser equalsParser = lexeme(charParser('='));
+Parser targetParser = lexeme(variableParser);
+
+// Parser for a parenthesized expression: '(' inner ')'. Each level of
+// parentheses is one level of native recursion, so it is counted as depth.
+Parser parenthesizedParser(const Parser& inner) {
+    return [&inner](string_view input, ParseContext& context) -> Result {
+        DepthGuard guard(context);
+        if (!guard) return nullopt;
+        auto open = openParser(input, context);
+        if (!open) return nullopt;
+        auto value = inner(open->second, context);
+        if (!value) return nullopt;
+        auto close = closeParser(value->second, context);
+        if (!close) return nullopt;
+        return make_pair(move(value->first), close->second);
+    };
+}
+
+// Defined below; terms and expressions refer to each other
+extern Parser expressionParser;
+
+// Parser for a term (number, variable or parenthesized expression)
+Parser termParser = lexeme(orParser(numberParser, variableParser, parenthesizedParser(expressionParser)));
+
+// Parser for expressions: expr := expr '+' term | term, folded in a loop so
+// that long chains are left associative and use constant stack
+Parser expressionParser = [](string_view input, ParseContext& context) -> Result {
+    DepthGuard guard(context);
+    if (!guard) return nullopt;
+    auto result = termParser(input, context);
+    if (!result) return nullopt;
+    Node tree = move(result->first);
+    string_view remaining = result->second;
+    while (auto plus = plusParser(remaining, context)) {
+        auto right = termParser(plus->second, context);
+        if (!right) break;
+        tree = make_unique<BinaryOpNode>('+', move(tree), move(right->first));
+        remaining = right->second;
+    }
+    if (context.expired()) return nullopt;
+    return make_pair(move(tree), remaining);
+};
+
+// Demo only: the same language written the naive backtracking way,
+//     expr := term '+' expr | term
+// When the first alternative fails, the term is parsed again from scratch,
+// so nested parentheses without a '+' take time exponential in the depth.
+extern Parser naiveExpressionParser;
+
+Parser naiveTermParser = lexeme(orParser(numberParser, variableParser, parenthesizedParser(naiveExpressionParser)));
+
+Parser naiveSumParser = [](string_view input, ParseContext& context) -> Result {
+    DepthGuard guard(context);
+    if (!guard) return nullopt;
+    auto left = naiveTermParser(input, context);
+    if (!left) return nullopt;
+    auto plus = plusParser(left->second, context);
+    if (!plus) return nullopt;
+    auto right = naiveExpressionParser(plus->second, context);
+    if (!right) return nullopt;
+    return make_pair(make_unique<BinaryOpNode>('+', move(left->first), move(right->first)), right->second);
+};
+
+Parser naiveExpressionParser = orParser(naiveSumParser, naiveTermParser);
+
+// Parser for assignment (variable = expression) with the given expression rule
+Parser assignmentParser(const Parser& expression) {
+    return [&expression](string_view input, ParseContext& context) -> Result {
+        auto variableResult = targetParser(input, context);
+        if (!variableResult) return nullopt;
+        auto equalsResult = equalsParser(variableResult->second, context);
+        if (!equalsResult) return nullopt;
+        auto expressionResult = expression(equalsResult->second, context);
+        if (!expressionResult) return nullopt;
+        return make_pair(make_unique<AssignmentNode>(move(variableResult->first), move(expressionResult->first)),
+                         expressionResult->second);
+    };
+}
+
+Parser statementParser = assignmentParser(expressionParser);
+Parser naiveStatementParser = assignmentParser(naiveExpressionParser);
+
+// Outcome of one request. Running out of steps or time is reported apart
+// from nesting too deep, and both apart from bad syntax.
+enum class ParseStatus : uint8_t {
+    Ok,
+    Timeout,
+    TooDeep
+};
+
+struct ParseOutcome {
+    ParseStatus status;
+    Limit limit;
+    vector<Node> statements;
+    size_t skippedBytes;
+    uint64_t steps;
+    chrono::microseconds elapsed;
+};
+
+// The main loop of the earlier parsers: parse what can be parsed and skip a
+// byte when nothing matches. The skip loop spends steps from the same budget.
+ParseOutcome parseRequest(const Parser& statement, string_view input, uint64_t maxSteps,
+                          chrono::steady_clock::duration timeLimit, uint32_t maxDepth) {
+    ParseContext context(maxSteps, timeLimit, maxDepth);
+    ParseOutcome outcome{ParseStatus::Ok, Limit::None, {}, 0, 0, {}};
+    while (!input.empty() && context.step()) {
+        if (auto result = statement(input, context); result) {
+            outcome.statements.push_back(move(result->first));
+            input = result->second;
+        } else if (!context.expired()) {
+            // Skip invalid characters
+            input.remove_prefix(1);
+            outcome.skippedBytes++;
+        }
+    }
+    if (context.expired()) {
+        outcome.limit = context.reason();
+        outcome.status = outcome.limit == Limit::Depth ? ParseStatus::TooDeep : ParseStatus::Timeout;
+        outcome.statements.clear();
+    }
+    outcome.steps = context.stepsTaken();
+    outcome.elapsed = context.elapsed();
+    return outcome;
+}
+
+const char* limitName(Limit limit) {
+    switch (limit) {
+    case Limit::Steps:
+        return "step budget";
+    case Limit::Deadline:
+        return "deadline";
+    case Limit::Depth:
+        return "nesting depth";
+    default:
+        return "none";
+    }
+}
+
+// Test the parser
+int main() {
+    const uint64_t maxSteps = 2'000'000;
+    const auto timeLimit = chrono::milliseconds(50);
+    const uint32_t maxDepth = 1000;
+
+    string nested = "x = " + string(40, '(') + "1" + string(40, ')');
+    string deep = "x = " + string(200000, '(') + "1";
+    string garbage = string(200000, '#') + " x = 1";
+    string chain = "total = 1";
+    for (int i = 0; i < 10000; i++) {
+        chain += " + a" + to_string(i);
+    }
+
+    struct Request {
+        const char* name;
+        const Parser& statement;
+        string text;
+        uint64_t maxSteps;
+    };
+    Request requests[] = {
+        {"simple", statementParser, "x = 42 + y_2 ; y = (x + 1) + 2", maxSteps},
+        {"long chain", statementParser, chain, maxSteps},
+        {"deeply nested parentheses", statementParser, deep, maxSteps},
+        {"long garbage prefix", statementParser, garbage, maxSteps},
+        {"nested parentheses", statementParser, nested, maxSteps},
+        {"nested parentheses, naive rule", naiveStatementParser, nested, maxSteps},
+        {"nested parentheses, naive rule, large step budget", naiveStatementParser, nested, UINT64_MAX},
+    };
+
+    for (const auto& request : requests) {
+        ParseOutcome outcome = parseRequest(request.statement, request.text, request.maxSteps, timeLimit, maxDepth);
+        cout << request.name << ": ";
+        if (outcome.status == ParseStatus::Timeout) {
+            cout << "timeout (" << limitName(outcome.limit) << ")";
+        } else if (outcome.status == ParseStatus::TooDeep) {
+            cout << "nested too deeply";
+        } else {
+            cout << outcome.statements.size() << " statements, " << outcome.skippedBytes << " bytes skipped";
+        }
+        cout << ", " << outcome.steps << " steps, " << outcome.elapsed.count() << " us" << endl;
+        if (request.text.size() < 64 && outcome.status == ParseStatus::Ok) {
+            for (const auto& statement : outcome.statements) {
+                cout << "  Parsed: ";
+                statement->print();
+                cout << endl;
+            }
+        }
+    }
+
+    return 0;
+}
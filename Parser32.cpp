@@ -0,0 +1,590 @@
+// variableParser and numberParser are hand written loops and composing character rules with orParser is slow; add regex like token combinators seq, alt, star and character classes that compile a whole token set once into a minimized DFA with a dense transition table, so lexing is one table driven loop
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+
+// Character classes used by the token definitions
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Regular expression over bytes, built with the combinators below. Nodes are
+// immutable and shared, so a sub-expression can be reused in several tokens.
+struct Regex {
+    enum class Kind : uint8_t {
+        Empty,
+        Chars,
+        Seq,
+        Alt,
+        Star
+    };
+
+    Kind kind;
+    CharSet set;
+    shared_ptr<const Regex> left;
+    shared_ptr<const Regex> right;
+};
+
+using Pattern = shared_ptr<const Regex>;
+
+// Matches the empty string
+Pattern epsilon() {
+    return make_shared<const Regex>(Regex{Regex::Kind::Empty, {}, nullptr, nullptr});
+}
+
+// Matches one byte of a set
+Pattern chars(CharSet set) {
+    return make_shared<const Regex>(Regex{Regex::Kind::Chars, set, nullptr, nullptr});
+}
+
+// Sequence of patterns
+template<typename... Patterns>
+Pattern seq(Pattern first, Patterns... rest) {
+    Pattern result = first;
+    for (Pattern next : {rest...}) {
+        result = make_shared<const Regex>(Regex{Regex::Kind::Seq, {}, result, next});
+    }
+    return result;
+}
+
+// Any one of the patterns
+template<typename... Patterns>
+Pattern alt(Pattern first, Patterns... rest) {
+    Pattern result = first;
+    for (Pattern next : {rest...}) {
+        result = make_shared<const Regex>(Regex{Regex::Kind::Alt, {}, result, next});
+    }
+    return result;
+}
+
+// Zero or more repetitions
+Pattern star(Pattern pattern) {
+    return make_shared<const Regex>(Regex{Regex::Kind::Star, {}, pattern, nullptr});
+}
+
+// One or more repetitions
+Pattern many1(Pattern pattern) {
+    return seq(pattern, star(pattern));
+}
+
+// Zero or one occurrence
+Pattern opt(Pattern pattern) {
+    return alt(pattern, epsilon());
+}
+
+// The exact text
+Pattern literal(string_view text) {
+    Pattern result = epsilon();
+    for (char c : text) {
+        result = seq(result, chars(c));
+    }
+    return result;
+}
+
+// A named token and the pattern that recognizes it. Earlier specs win when two
+// tokens match the same longest prefix, so keywords go before identifiers.
+struct TokenRule {
+    string name;
+    Pattern pattern;
+    bool skip = false;  // matched but not reported, e.g. whitespace
+};
+
+// Thompson NFA: each state has byte edges and epsilon edges
+class Nfa {
+public:
+    struct State {
+        vector<pair<CharSet, int>> edges;
+        vector<int> epsilons;
+        int accept = -1;  // token index, or -1
+    };
+
+    explicit Nfa(const vector<TokenRule>& rules) {
+        states.emplace_back();  // the start state
+        for (size_t i = 0; i < rules.size(); i++) {
+            auto [begin, end] = build(*rules[i].pattern);
+            states[0].epsilons.push_back(begin);
+            states[end].accept = static_cast<int>(i);
+        }
+    }
+
+    vector<State> states;
+
+private:
+    int addState() {
+        states.emplace_back();
+        return static_cast<int>(states.size() - 1);
+    }
+
+    // Returns the entry and exit state of the fragment for a pattern
+    pair<int, int> build(const Regex& regex) {
+        int begin = addState();
+        int end = addState();
+        switch (regex.kind) {
+        case Regex::Kind::Empty:
+            states[begin].epsilons.push_back(end);
+            break;
+        case Regex::Kind::Chars:
+            states[begin].edges.emplace_back(regex.set, end);
+            break;
+        case Regex::Kind::Seq: {
+            auto [leftBegin, leftEnd] = build(*regex.left);
+            auto [rightBegin, rightEnd] = build(*regex.right);
+            states[begin].epsilons.push_back(leftBegin);
+            states[leftEnd].epsilons.push_back(rightBegin);
+            states[rightEnd].epsilons.push_back(end);
+            break;
+        }
+        case Regex::Kind::Alt: {
+            auto [leftBegin, leftEnd] = build(*regex.left);
+            auto [rightBegin, rightEnd] = build(*regex.right);
+            states[begin].epsilons.push_back(leftBegin);
+            states[begin].epsilons.push_back(rightBegin);
+            states[leftEnd].epsilons.push_back(end);
+            states[rightEnd].epsilons.push_back(end);
+            break;
+        }
+        case Regex::Kind::Star: {
+            auto [innerBegin, innerEnd] = build(*regex.left);
+            states[begin].epsilons.push_back(innerBegin);
+            states[begin].epsilons.push_back(end);
+            states[innerEnd].epsilons.push_back(innerBegin);
+            states[innerEnd].epsilons.push_back(end);
+            break;
+        }
+        }
+        return {begin, end};
+    }
+};
+
+// Result of a longest-match lookup; token is an index into the rules
+struct DfaMatch {
+    int token = -1;
+    size_t length = 0;
+};
+
+// Minimized DFA with a dense transition table. Bytes that no token tells
+// apart share an equivalence class, so a row is one entry per class rather
+// than 256. State 0 is the dead state and state 1 the start state.
+class Dfa {
+public:
+    static constexpr uint16_t dead = 0;
+    static constexpr uint16_t start = 1;
+
+    explicit Dfa(const vector<TokenRule>& rules) {
+        Nfa nfa(rules);
+        nfaStates = nfa.states.size();
+        computeByteClasses(nfa);
+        determinize(nfa);
+        subsetStates = accept.size();
+        minimize();
+    }
+
+    // Longest prefix of input that is a token; ties go to the earlier rule
+    DfaMatch longestMatch(string_view input) const {
+        DfaMatch match;
+        uint16_t state = start;
+        const uint16_t* table = transitions.data();
+        for (size_t pos = 0; pos < input.size(); pos++) {
+            state = table[state * classCount + byteClass[static_cast<unsigned char>(input[pos])]];
+            if (state == dead) break;
+            if (accept[state] >= 0) {
+                match = DfaMatch{accept[state], pos + 1};
+            }
+        }
+        return match;
+    }
+
+    size_t states() const {
+        return accept.size();
+    }
+
+    size_t classes() const {
+        return classCount;
+    }
+
+    size_t nfaStates = 0;
+    size_t subsetStates = 0;
+
+private:
+    // Two bytes are equivalent when every character set in the NFA either
+    // contains both or neither of them
+    void computeByteClasses(const Nfa& nfa) {
+        vector<CharSet> sets;
+        for (const auto& state : nfa.states) {
+            for (const auto& edge : state.edges) {
+                sets.push_back(edge.first);
+            }
+        }
+        map<vector<bool>, uint8_t> signatures;
+        for (int c = 0; c < 256; c++) {
+            vector<bool> signature;
+            signature.reserve(sets.size());
+            for (const auto& set : sets) {
+                signature.push_back(set.contains(static_cast<unsigned char>(c)));
+            }
+            auto it = signatures.emplace(move(signature), static_cast<uint8_t>(signatures.size())).first;
+            byteClass[c] = it->second;
+        }
+        classCount = signatures.size();
+        // One representative byte per class, used while building the table
+        representatives.assign(classCount, 0);
+        for (int c = 255; c >= 0; c--) {
+            representatives[byteClass[c]] = static_cast<unsigned char>(c);
+        }
+    }
+
+    static void closure(const Nfa& nfa, vector<int>& set) {
+        vector<bool> seen(nfa.states.size());
+        vector<int> stack = set;
+        for (int state : set) {
+            seen[state] = true;
+        }
+        while (!stack.empty()) {
+            int state = stack.back();
+            stack.pop_back();
+            for (int next : nfa.states[state].epsilons) {
+                if (!seen[next]) {
+                    seen[next] = true;
+                    set.push_back(next);
+                    stack.push_back(next);
+                }
+            }
+        }
+        sort(set.begin(), set.end());
+    }
+
+    // Subset construction over byte classes
+    void determinize(const Nfa& nfa) {
+        map<vector<int>, uint16_t> ids;
+        vector<vector<int>> sets;
+        auto intern = [&](vector<int> set) -> uint16_t {
+            auto [it, inserted] = ids.emplace(set, static_cast<uint16_t>(sets.size()));
+            if (inserted) {
+                sets.push_back(move(set));
+            }
+            return it->second;
+        };
+
+        intern({});  // the dead state
+        vector<int> initial{0};
+        closure(nfa, initial);
+        intern(initial);
+
+        for (size_t id = 0; id < sets.size(); id++) {
+            int token = -1;
+            for (int state : sets[id]) {
+                int stateAccept = nfa.states[state].accept;
+                if (stateAccept >= 0 && (token < 0 || stateAccept < token)) token = stateAccept;
+            }
+            accept.push_back(token);
+
+            for (size_t cls = 0; cls < classCount; cls++) {
+                vector<int> next;
+                for (int state : sets[id]) {
+                    for (const auto& [set, target] : nfa.states[state].edges) {
+                        if (set.contains(representatives[cls])) next.push_back(target);
+                    }
+                }
+                sort(next.begin(), next.end());
+                next.erase(unique(next.begin(), next.end()), next.end());
+                closure(nfa, next);
+                // sets may reallocate inside intern, so do not keep references into it
+                uint16_t target = intern(move(next));
+                transitions.push_back(target);
+            }
+        }
+    }
+
+    // Moore partition refinement: start from blocks of equal accepted token
+    // and split blocks until all states in a block move to the same blocks
+    void minimize() {
+        size_t count = accept.size();
+        vector<uint16_t> block(count);
+        {
+            map<int, uint16_t> byToken;
+            // Dead and start keep their own blocks so their ids stay 0 and 1
+            block[dead] = 0;
+            block[start] = 1;
+            for (size_t state = 2; state < count; state++) {
+                block[state] = byToken.emplace(accept[state], static_cast<uint16_t>(byToken.size() + 2)).first->second;
+            }
+        }
+
+        size_t blocks = 0;
+        while (true) {
+            map<vector<int>, uint16_t> signatures;
+            vector<uint16_t> refined(count);
+            for (size_t state = 0; state < count; state++) {
+                vector<int> signature{block[state], accept[state]};
+                // The dead and start states are never merged with anything
+                if (state == dead || state == start) signature.push_back(-1 - static_cast<int>(state));
+                for (size_t cls = 0; cls < classCount; cls++) {
+                    signature.push_back(block[transitions[state * classCount + cls]]);
+                }
+                refined[state] = signatures.emplace(move(signature), static_cast<uint16_t>(signatures.size())).first->second;
+            }
+            block.swap(refined);
+            if (signatures.size() == blocks) break;
+            blocks = signatures.size();
+        }
+
+        // Renumber so that the dead state is 0 and the start state is 1
+        vector<int> order(blocks, -1);
+        int next = 0;
+        order[block[dead]] = next++;
+        order[block[start]] = next++;
+        for (size_t state = 0; state < count; state++) {
+            if (order[block[state]] < 0) order[block[state]] = next++;
+        }
+
+        vector<uint16_t> minimized(blocks * classCount);
+        vector<int16_t> minimizedAccept(blocks);
+        for (size_t state = 0; state < count; state++) {
+            size_t row = order[block[state]];
+            minimizedAccept[row] = static_cast<int16_t>(accept[state]);
+            for (size_t cls = 0; cls < classCount; cls++) {
+                minimized[row * classCount + cls] = static_cast<uint16_t>(order[block[transitions[state * classCount + cls]]]);
+            }
+        }
+        transitions.swap(minimized);
+        accept.assign(minimizedAccept.begin(), minimizedAccept.end());
+    }
+
+    uint8_t byteClass[256] = {};
+    size_t classCount = 0;
+    vector<unsigned char> representatives;
+    vector<uint16_t> transitions;
+    vector<int16_t> accept;
+};
+
+// A token reported by the lexer: the rule index and a span of the input
+struct Token {
+    int rule;
+    string_view text;
+};
+
+// Maximal munch lexer driven by the DFA. Bytes no rule accepts are reported
+// as tokens with rule -1 so the caller decides how to recover.
+size_t lexAll(const Dfa& dfa, const vector<TokenRule>& rules, string_view input, vector<Token>& tokens) {
+    size_t invalid = 0;
+    while (!input.empty()) {
+        DfaMatch match = dfa.longestMatch(input);
+        if (match.token < 0) {
+            tokens.push_back(Token{-1, input.substr(0, 1)});
+            input.remove_prefix(1);
+            invalid++;
+            continue;
+        }
+        if (!rules[match.token].skip) {
+            tokens.push_back(Token{match.token, input.substr(0, match.length)});
+        }
+        input.remove_prefix(match.length);
+    }
+    return invalid;
+}
+
+// The token set of the language
+vector<TokenRule> languageRules() {
+    vector<TokenRule> rules;
+    for (const char* keyword : {"if", "else", "while", "for", "return", "int", "auto", "const", "constexpr"}) {
+        rules.push_back({keyword, literal(keyword)});
+    }
+    rules.push_back({"identifier", seq(chars(letters), star(chars(identifierChars)))});
+    // Integers, with an optional fraction and exponent
+    rules.push_back({"number", seq(many1(chars(digits)), opt(seq(chars('.'), many1(chars(digits)))),
+                                   opt(seq(chars(CharSet('e') | 'E'), opt(chars(CharSet('+') | '-')), many1(chars(digits)))))});
+    for (const char* op : {"=", "==", "!=", "+", "+=", "++", "-", "-=", "--", "->", "*", "*=", "/", "/=", "<", "<=",
+                           "<<", "<<=", ">", ">=", ">>", ">>=", "&&", "||", "(", ")", ";"}) {
+        rules.push_back({op, literal(op)});
+    }
+    rules.push_back({"space", many1(chars(spaces)), true});
+    rules.push_back({"comment", seq(literal("//"), star(chars(CharSet::range('\0', '\t') | CharSet::range('\v', '\xff')))), true});
+    return rules;
+}
+
+// The same token set written the combinator way: every rule is a hand coded
+// function and the longest match means trying all of them at each position
+using TokenParser = function<size_t(string_view)>;
+
+vector<TokenParser> handWrittenRules(const vector<TokenRule>& rules) {
+    vector<TokenParser> parsers;
+    for (const auto& rule : rules) {
+        const string& name = rule.name;
+        if (name == "identifier") {
+            parsers.push_back([](string_view input) -> size_t {
+                if (input.empty() || !isalpha(static_cast<unsigned char>(input[0]))) return 0;
+                size_t pos = 1;
+                while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) pos++;
+                return pos;
+            });
+        } else if (name == "number") {
+            parsers.push_back([](string_view input) -> size_t {
+                auto run = [&](size_t pos) {
+                    while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) pos++;
+                    return pos;
+                };
+                size_t pos = run(0);
+                if (pos == 0) return 0;
+                if (pos + 1 < input.size() && input[pos] == '.' && isdigit(static_cast<unsigned char>(input[pos + 1]))) {
+                    pos = run(pos + 1);
+                }
+                if (pos < input.size() && (input[pos] == 'e' || input[pos] == 'E')) {
+                    size_t exponent = pos + 1;
+                    if (exponent < input.size() && (input[exponent] == '+' || input[exponent] == '-')) exponent++;
+                    size_t end = run(exponent);
+                    if (end > exponent) pos = end;
+                }
+                return pos;
+            });
+        } else if (name == "space") {
+            parsers.push_back([](string_view input) -> size_t {
+                size_t pos = 0;
+                while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) pos++;
+                return pos;
+            });
+        } else if (name == "comment") {
+            parsers.push_back([](string_view input) -> size_t {
+                if (input.substr(0, 2) != "//") return 0;
+                size_t end = input.find('\n');
+                return end == string_view::npos ? input.size() : end;
+            });
+        } else {
+            parsers.push_back([name](string_view input) -> size_t {
+                return input.substr(0, name.size()) == name ? name.size() : 0;
+            });
+        }
+    }
+    return parsers;
+}
+
+size_t lexAllHandWritten(const vector<TokenParser>& parsers, const vector<TokenRule>& rules, string_view input,
+                         vector<Token>& tokens) {
+    size_t invalid = 0;
+    while (!input.empty()) {
+        int best = -1;
+        size_t bestLength = 0;
+        for (size_t i = 0; i < parsers.size(); i++) {
+            size_t length = parsers[i](input);
+            if (length > bestLength) {
+                best = static_cast<int>(i);
+                bestLength = length;
+            }
+        }
+        if (best < 0) {
+            tokens.push_back(Token{-1, input.substr(0, 1)});
+            input.remove_prefix(1);
+            invalid++;
+            continue;
+        }
+        if (!rules[best].skip) {
+            tokens.push_back(Token{best, input.substr(0, bestLength)});
+        }
+        input.remove_prefix(bestLength);
+    }
+    return invalid;
+}
+
+// Test the lexer
+int main() {
+    vector<TokenRule> rules = languageRules();
+    Dfa dfa(rules);
+    cout << "NFA states: " << dfa.nfaStates << ", DFA states: " << dfa.subsetStates << ", minimized: " << dfa.states()
+         << ", byte classes: " << dfa.classes() << endl;
+
+    string input = "x = 42 + y_2; if (x >= 1.5e3) iffy <<= x -> y // trailing comment\nreturn $ x";
+    vector<Token> tokens;
+    size_t invalid = lexAll(dfa, rules, input, tokens);
+    for (const auto& token : tokens) {
+        cout << (token.rule < 0 ? "invalid" : rules[token.rule].name) << "(" << token.text << ") ";
+    }
+    cout << endl << invalid << " invalid bytes" << endl;
+
+    // Both lexers must agree on a large input before their speed is compared
+    string program;
+    for (int i = 0; i < 100000; i++) {
+        program += "value_" + to_string(i) + " = " + to_string(i) + " + y_2 * 3.25e-1; if (value_" + to_string(i) +
+                   " <= limit) return x;\n";
+    }
+
+    vector<TokenParser> parsers = handWrittenRules(rules);
+    vector<Token> dfaTokens, handTokens;
+    dfaTokens.reserve(2000000);
+    handTokens.reserve(2000000);
+
+    auto start = chrono::steady_clock::now();
+    lexAll(dfa, rules, program, dfaTokens);
+    auto dfaDone = chrono::steady_clock::now();
+    lexAllHandWritten(parsers, rules, program, handTokens);
+    auto handDone = chrono::steady_clock::now();
+
+    bool same = dfaTokens.size() == handTokens.size();
+    for (size_t i = 0; same && i < dfaTokens.size(); i++) {
+        same = dfaTokens[i].rule == handTokens[i].rule && dfaTokens[i].text == handTokens[i].text;
+    }
+    cout << "DFA lexer: " << dfaTokens.size() << " tokens in "
+         << chrono::duration_cast<chrono::milliseconds>(dfaDone - start).count() << " ms" << endl;
+    cout << "Hand written rules: " << handTokens.size() << " tokens in "
+         << chrono::duration_cast<chrono::milliseconds>(handDone - dfaDone).count() << " ms" << endl;
+    if (!same) {
+        cout << "The lexers disagree" << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,716 @@
+// every grammar change means editing and recompiling a ParserN.cpp file; load an EBNF grammar at startup, compile it into LL(1) parse tables and run it with one generic driver that uses an explicit stack and emits VariableNode, NumberNode, AssignmentNode and BinaryOpNode
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Abstract syntax tree (AST) node classes
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+};
+
+class VariableNode : public ASTNode {
+public:
+    string name;
+    VariableNode(const string& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+};
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+
+// Character classes used by the grammar reader and the token scanner
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Thrown when a grammar cannot be read or is not LL(1)
+class GrammarError : public runtime_error {
+public:
+    using runtime_error::runtime_error;
+};
+
+// A grammar symbol: a terminal, a nonterminal, or an action marker that the
+// driver runs when it reaches it
+enum class SymbolKind : uint8_t {
+    Terminal,
+    Nonterminal,
+    Action
+};
+
+struct Symbol {
+    SymbolKind kind;
+    uint32_t id;
+};
+
+// Actions build nodes on the driver's value stack:
+//     @variable  pop the last NAME, push a VariableNode
+//     @number    pop the last NUMBER, push a NumberNode
+//     @binop:c   pop right and left, push BinaryOpNode(c, left, right)
+//     @assign    pop value and target, push an AssignmentNode
+enum class ActionKind : uint8_t {
+    Variable,
+    Number,
+    BinaryOp,
+    Assign
+};
+
+struct Action {
+    ActionKind kind;
+    char op;
+};
+
+struct Production {
+    uint32_t head;
+    vector<Symbol> body;
+};
+
+// Terminals with fixed ids; literals from the grammar text follow them
+constexpr uint32_t endTerminal = 0;
+constexpr uint32_t nameTerminal = 1;
+constexpr uint32_t numberTerminal = 2;
+
+// A grammar in plain BNF form. EBNF repetition, options and groups are
+// rewritten into helper nonterminals while reading, e.g. { X } becomes
+//     R = X R | (empty)
+struct Grammar {
+    vector<string> terminals{"end of input", "NAME", "NUMBER"};
+    vector<string> nonterminals;
+    vector<Action> actions;
+    vector<Production> productions;
+    uint32_t start = 0;
+};
+
+// Reader for grammar text of the form
+//     rule = alternative | alternative ;
+// where an alternative is a sequence of rule names, NAME, NUMBER, quoted
+// literals, @actions, { repetition }, [ option ] and ( group ). The first
+// rule is the start symbol.
+class GrammarReader {
+public:
+    explicit GrammarReader(string_view text) : text(text) {}
+
+    Grammar read() {
+        skipSpaces();
+        while (pos < text.size()) {
+            string name = identifier();
+            uint32_t head = nonterminal(name);
+            if (defined.size() <= head) defined.resize(head + 1);
+            if (defined[head]) fail("rule '" + name + "' is defined twice");
+            defined[head] = true;
+            expect('=');
+            for (auto& body : alternatives()) {
+                grammar.productions.push_back(Production{head, move(body)});
+            }
+            expect(';');
+        }
+        if (grammar.nonterminals.empty()) fail("the grammar has no rules");
+        defined.resize(grammar.nonterminals.size());
+        for (size_t i = 0; i < grammar.nonterminals.size(); i++) {
+            if (!defined[i]) throw GrammarError("rule '" + grammar.nonterminals[i] + "' is used but never defined");
+        }
+        return move(grammar);
+    }
+
+private:
+    using Alternatives = vector<vector<Symbol>>;
+
+    Alternatives alternatives() {
+        Alternatives result{sequence()};
+        while (accept('|')) {
+            result.push_back(sequence());
+        }
+        return result;
+    }
+
+    vector<Symbol> sequence() {
+        vector<Symbol> body;
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c == '"') {
+                body.push_back(Symbol{SymbolKind::Terminal, literal()});
+            } else if (c == '@') {
+                body.push_back(Symbol{SymbolKind::Action, action()});
+            } else if (c == '{' || c == '[' || c == '(') {
+                pos++;
+                skipSpaces();
+                body.push_back(Symbol{SymbolKind::Nonterminal, helper(c, alternatives())});
+                expect(c == '{' ? '}' : c == '[' ? ']' : ')');
+            } else if (letters.contains(static_cast<unsigned char>(c))) {
+                string name = identifier();
+                if (name == "NAME") {
+                    body.push_back(Symbol{SymbolKind::Terminal, nameTerminal});
+                } else if (name == "NUMBER") {
+                    body.push_back(Symbol{SymbolKind::Terminal, numberTerminal});
+                } else {
+                    body.push_back(Symbol{SymbolKind::Nonterminal, nonterminal(name)});
+                }
+            } else {
+                break;
+            }
+        }
+        return body;
+    }
+
+    // Helper nonterminal for a {repetition}, [option] or (group)
+    uint32_t helper(char bracket, Alternatives alternativesInside) {
+        uint32_t id = nonterminal("#" + to_string(helpers++));
+        defined.resize(id + 1);
+        defined[id] = true;
+        for (auto& body : alternativesInside) {
+            if (bracket == '{') body.push_back(Symbol{SymbolKind::Nonterminal, id});
+            grammar.productions.push_back(Production{id, move(body)});
+        }
+        if (bracket != '(') {
+            grammar.productions.push_back(Production{id, {}});
+        }
+        return id;
+    }
+
+    uint32_t literal() {
+        size_t end = text.find('"', pos + 1);
+        if (end == string_view::npos || end == pos + 1) fail("bad literal");
+        string value(text.substr(pos + 1, end - pos - 1));
+        pos = end + 1;
+        skipSpaces();
+        auto it = find(grammar.terminals.begin(), grammar.terminals.end(), value);
+        if (it != grammar.terminals.end() && it - grammar.terminals.begin() > numberTerminal) {
+            return static_cast<uint32_t>(it - grammar.terminals.begin());
+        }
+        grammar.terminals.push_back(value);
+        return static_cast<uint32_t>(grammar.terminals.size() - 1);
+    }
+
+    uint32_t action() {
+        pos++;
+        string name = identifier(false);
+        Action result{};
+        if (name == "variable") {
+            result.kind = ActionKind::Variable;
+        } else if (name == "number") {
+            result.kind = ActionKind::Number;
+        } else if (name == "assign") {
+            result.kind = ActionKind::Assign;
+        } else if (name == "binop") {
+            if (pos + 1 >= text.size() || text[pos] != ':') fail("@binop needs an operator, e.g. @binop:+");
+            result.kind = ActionKind::BinaryOp;
+            result.op = text[pos + 1];
+            pos += 2;
+        } else {
+            fail("unknown action @" + name);
+        }
+        skipSpaces();
+        grammar.actions.push_back(result);
+        return static_cast<uint32_t>(grammar.actions.size() - 1);
+    }
+
+    uint32_t nonterminal(const string& name) {
+        auto [it, inserted] = nonterminalIds.emplace(name, static_cast<uint32_t>(grammar.nonterminals.size()));
+        if (inserted) grammar.nonterminals.push_back(name);
+        return it->second;
+    }
+
+    string identifier(bool skipAfter = true) {
+        size_t begin = pos;
+        if (pos >= text.size() || !letters.contains(static_cast<unsigned char>(text[pos]))) fail("expected a name");
+        while (pos < text.size() && identifierChars.contains(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        string name(text.substr(begin, pos - begin));
+        if (skipAfter) skipSpaces();
+        return name;
+    }
+
+    bool accept(char c) {
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            skipSpaces();
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!accept(c)) fail(string("expected '") + c + "'");
+    }
+
+    void skipSpaces() {
+        while (pos < text.size() && spaces.contains(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+    }
+
+    [[noreturn]] void fail(const string& message) const {
+        throw GrammarError("grammar offset " + to_string(pos) + ": " + message);
+    }
+
+    string_view text;
+    size_t pos = 0;
+    size_t helpers = 0;
+    Grammar grammar;
+    unordered_map<string, uint32_t> nonterminalIds;
+    vector<bool> defined;
+};
+
+// LL(1) table compiled from a grammar: FIRST and FOLLOW sets, then one
+// production per (nonterminal, lookahead terminal) cell. A cell claimed
+// twice is a conflict and the grammar is rejected, naming the cell.
+class ParseTable {
+public:
+    static constexpr int32_t noProduction = -1;
+
+    explicit ParseTable(const Grammar& grammar)
+        : terminalCount(grammar.terminals.size()),
+          cells(grammar.nonterminals.size() * grammar.terminals.size(), noProduction) {
+        size_t nonterminals = grammar.nonterminals.size();
+        nullable.assign(nonterminals, false);
+        first.assign(nonterminals, vector<bool>(terminalCount));
+        follow.assign(nonterminals, vector<bool>(terminalCount));
+        follow[grammar.start][endTerminal] = true;
+
+        // Iterate to a fixed point; grammars are small, so the simple way is fine
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (const auto& production : grammar.productions) {
+                vector<bool> bodyFirst(terminalCount);
+                bool bodyNullable = firstOf(production.body, 0, bodyFirst);
+                changed |= merge(first[production.head], bodyFirst);
+                if (bodyNullable && !nullable[production.head]) {
+                    nullable[production.head] = true;
+                    changed = true;
+                }
+
+                for (size_t i = 0; i < production.body.size(); i++) {
+                    const Symbol& symbol = production.body[i];
+                    if (symbol.kind != SymbolKind::Nonterminal) continue;
+                    vector<bool> rest(terminalCount);
+                    if (firstOf(production.body, i + 1, rest)) {
+                        merge(rest, follow[production.head]);
+                    }
+                    changed |= merge(follow[symbol.id], rest);
+                }
+            }
+        }
+
+        for (size_t p = 0; p < grammar.productions.size(); p++) {
+            const Production& production = grammar.productions[p];
+            vector<bool> lookahead(terminalCount);
+            if (firstOf(production.body, 0, lookahead)) {
+                merge(lookahead, follow[production.head]);
+            }
+            for (size_t terminal = 0; terminal < terminalCount; terminal++) {
+                if (!lookahead[terminal]) continue;
+                int32_t& cell = cells[production.head * terminalCount + terminal];
+                if (cell != noProduction && cell != static_cast<int32_t>(p)) {
+                    throw GrammarError("LL(1) conflict in rule '" + grammar.nonterminals[production.head] +
+                                       "' on " + describe(grammar, terminal));
+                }
+                cell = static_cast<int32_t>(p);
+            }
+        }
+    }
+
+    int32_t lookup(uint32_t nonterminal, uint32_t terminal) const {
+        if (terminal >= terminalCount) return noProduction;
+        return cells[nonterminal * terminalCount + terminal];
+    }
+
+    // Terminals that may start the given nonterminal, for error messages
+    string expected(const Grammar& grammar, uint32_t nonterminal) const {
+        string result;
+        for (size_t terminal = 0; terminal < terminalCount; terminal++) {
+            if (lookup(nonterminal, static_cast<uint32_t>(terminal)) == noProduction) continue;
+            result += (result.empty() ? "" : ", ") + describe(grammar, terminal);
+        }
+        return result;
+    }
+
+    static string describe(const Grammar& grammar, size_t terminal) {
+        return terminal > numberTerminal ? "\"" + grammar.terminals[terminal] + "\"" : grammar.terminals[terminal];
+    }
+
+private:
+    // FIRST of body[from..]; returns whether that suffix is nullable
+    bool firstOf(const vector<Symbol>& body, size_t from, vector<bool>& out) const {
+        for (size_t i = from; i < body.size(); i++) {
+            const Symbol& symbol = body[i];
+            if (symbol.kind == SymbolKind::Action) continue;
+            if (symbol.kind == SymbolKind::Terminal) {
+                out[symbol.id] = true;
+                return false;
+            }
+            merge(out, first[symbol.id]);
+            if (!nullable[symbol.id]) return false;
+        }
+        return true;
+    }
+
+    static bool merge(vector<bool>& into, const vector<bool>& from) {
+        bool changed = false;
+        for (size_t i = 0; i < into.size(); i++) {
+            if (from[i] && !into[i]) {
+                into[i] = true;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    size_t terminalCount;
+    vector<int32_t> cells;
+    vector<bool> nullable;
+    vector<vector<bool>> first;
+    vector<vector<bool>> follow;
+};
+
+// A scanned token: terminal id and its text in the input
+struct Token {
+    uint32_t terminal;
+    string_view text;
+};
+
+// Outcome of running the driver
+struct ParseResult {
+    vector<unique_ptr<ASTNode>> nodes;
+    bool ok = false;
+    size_t errorOffset = 0;
+    string message;
+};
+
+// Grammar plus tables: the generic table driven parser
+class TableParser {
+public:
+    explicit TableParser(string_view grammarText) : grammar(GrammarReader(grammarText).read()), table(grammar) {
+        // Literals are tried longest first, so "<=" wins over "<"
+        for (uint32_t terminal = numberTerminal + 1; terminal < grammar.terminals.size(); terminal++) {
+            literalsByLength.push_back(terminal);
+        }
+        sort(literalsByLength.begin(), literalsByLength.end(), [this](uint32_t a, uint32_t b) {
+            return grammar.terminals[a].size() > grammar.terminals[b].size();
+        });
+    }
+
+    size_t productionCount() const {
+        return grammar.productions.size();
+    }
+
+    // Predictive parse with an explicit stack of grammar symbols; no recursion
+    ParseResult parse(string_view input) const {
+        ParseResult result;
+        vector<Symbol> stack{Symbol{SymbolKind::Terminal, endTerminal}, Symbol{SymbolKind::Nonterminal, grammar.start}};
+        vector<string_view> tokenValues;
+        vector<unique_ptr<ASTNode>>& values = result.nodes;
+
+        size_t pos = 0;
+        Token lookahead = scan(input, pos);
+        auto fail = [&](const string& message) {
+            result.nodes.clear();
+            result.errorOffset = lookahead.text.data() - input.data();
+            result.message = message + ", found " + (lookahead.terminal == endTerminal ? "end of input" : "'" + string(lookahead.text) + "'");
+            return move(result);
+        };
+
+        while (!stack.empty()) {
+            Symbol top = stack.back();
+            stack.pop_back();
+            switch (top.kind) {
+            case SymbolKind::Terminal:
+                if (lookahead.terminal != top.id) {
+                    return fail("expected " + ParseTable::describe(grammar, top.id));
+                }
+                if (top.id == nameTerminal || top.id == numberTerminal) {
+                    tokenValues.push_back(lookahead.text);
+                }
+                if (top.id != endTerminal) {
+                    lookahead = scan(input, pos);
+                }
+                break;
+            case SymbolKind::Nonterminal: {
+                int32_t production = table.lookup(top.id, lookahead.terminal);
+                if (production == ParseTable::noProduction) {
+                    return fail("expected " + table.expected(grammar, top.id));
+                }
+                const auto& body = grammar.productions[production].body;
+                stack.insert(stack.end(), body.rbegin(), body.rend());
+                break;
+            }
+            case SymbolKind::Action:
+                if (!runAction(grammar.actions[top.id], tokenValues, values)) {
+                    return fail("action failed");
+                }
+                break;
+            }
+        }
+
+        result.ok = true;
+        return result;
+    }
+
+private:
+    static bool runAction(const Action& action, vector<string_view>& tokenValues, vector<unique_ptr<ASTNode>>& values) {
+        switch (action.kind) {
+        case ActionKind::Variable:
+            if (tokenValues.empty()) return false;
+            values.push_back(make_unique<VariableNode>(string(tokenValues.back())));
+            tokenValues.pop_back();
+            return true;
+        case ActionKind::Number: {
+            if (tokenValues.empty()) return false;
+            string_view text = tokenValues.back();
+            tokenValues.pop_back();
+            int value = 0;
+            if (from_chars(text.data(), text.data() + text.size(), value).ec != errc()) return false;
+            values.push_back(make_unique<NumberNode>(value));
+            return true;
+        }
+        case ActionKind::BinaryOp:
+        case ActionKind::Assign: {
+            if (values.size() < 2) return false;
+            unique_ptr<ASTNode> right = move(values.back());
+            values.pop_back();
+            unique_ptr<ASTNode> left = move(values.back());
+            values.pop_back();
+            if (action.kind == ActionKind::BinaryOp) {
+                values.push_back(make_unique<BinaryOpNode>(action.op, move(left), move(right)));
+            } else {
+                values.push_back(make_unique<AssignmentNode>(move(left), move(right)));
+            }
+            return true;
+        }
+        }
+        return false;
+    }
+
+    // Next token: a grammar literal, NAME or NUMBER, whichever is longest;
+    // on a tie the literal wins, so keywords are not read as names
+    Token scan(string_view input, size_t& pos) const {
+        while (pos < input.size() && spaces.contains(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        if (pos == input.size()) return Token{endTerminal, input.substr(pos)};
+
+        size_t length = 0;
+        uint32_t terminal = endTerminal;
+        for (uint32_t literal : literalsByLength) {
+            const string& spelling = grammar.terminals[literal];
+            if (input.compare(pos, spelling.size(), spelling) == 0) {
+                length = spelling.size();
+                terminal = literal;
+                break;
+            }
+        }
+        unsigned char c = static_cast<unsigned char>(input[pos]);
+        uint32_t wordTerminal = letters.contains(c) ? nameTerminal : numberTerminal;
+        const CharSet& set = letters.contains(c) ? identifierChars : digits;
+        size_t end = pos;
+        while (end < input.size() && set.contains(static_cast<unsigned char>(input[end]))) {
+            end++;
+        }
+        if (end - pos > length) {
+            length = end - pos;
+            terminal = wordTerminal;
+        }
+        if (length == 0) {
+            // An unknown byte; no terminal has this id, so the parser reports it
+            return Token{static_cast<uint32_t>(grammar.terminals.size()), input.substr(pos++, 1)};
+        }
+        Token token{terminal, input.substr(pos, length)};
+        pos += length;
+        return token;
+    }
+
+    Grammar grammar;
+    ParseTable table;
+    vector<uint32_t> literalsByLength;
+};
+
+// The language of the earlier parsers, as grammar text
+constexpr string_view defaultGrammar = R"grammar(
+program    = { statement } ;
+statement  = NAME @variable "=" expression ";" @assign ;
+expression = term { "+" term @binop:+ } ;
+term       = NUMBER @number | NAME @variable | "(" expression ")" ;
+)grammar";
+
+// The same language with '-' and '*' added, loaded without a rebuild
+constexpr string_view extendedGrammar = R"grammar(
+program    = { statement } ;
+statement  = NAME @variable "=" expression ";" @assign ;
+expression = product { "+" product @binop:+ | "-" product @binop:- } ;
+product    = term { "*" term @binop:* } ;
+term       = NUMBER @number | NAME @variable | "(" expression ")" ;
+)grammar";
+
+void report(const TableParser& parser, string_view input) {
+    ParseResult result = parser.parse(input);
+    if (!result.ok) {
+        cout << "  error at offset " << result.errorOffset << ": " << result.message << endl;
+        return;
+    }
+    for (const auto& node : result.nodes) {
+        cout << "  Parsed: ";
+        node->print();
+        cout << endl;
+    }
+}
+
+// Test the parser; a grammar file can be given as the first argument
+int main(int argc, char* argv[]) {
+    string input = "x = 42 + y_2; z = (x + 1) + 7;";
+
+    vector<pair<string, string>> grammars{{"default grammar", string(defaultGrammar)}, {"extended grammar", string(extendedGrammar)}};
+    if (argc > 1) {
+        ifstream file(argv[1]);
+        if (!file) {
+            cerr << "Cannot open " << argv[1] << endl;
+            return 1;
+        }
+        stringstream text;
+        text << file.rdbuf();
+        grammars = {{argv[1], text.str()}};
+    }
+
+    for (const auto& [name, text] : grammars) {
+        try {
+            auto start = chrono::steady_clock::now();
+            TableParser parser(text);
+            auto loaded = chrono::steady_clock::now();
+            cout << name << ": " << parser.productionCount() << " productions compiled in "
+                 << chrono::duration_cast<chrono::microseconds>(loaded - start).count() << " us" << endl;
+            report(parser, input);
+            report(parser, "a = 2 * b - 1 + c;");
+            report(parser, "x = 42 + ;");
+
+            // A long chain is parsed without any recursion
+            string chain = "total = a0";
+            for (int i = 1; i < 100000; i++) {
+                chain += " + a" + to_string(i);
+            }
+            chain += ";";
+            auto chainStart = chrono::steady_clock::now();
+            ParseResult result = parser.parse(chain);
+            cout << "  100000 term chain: " << (result.ok ? "ok" : result.message) << " in "
+                 << chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - chainStart).count() << " ms" << endl;
+            // The chain is left deep; hand it out one level at a time
+            // so destroying it does not recurse through 100000 levels
+            if (result.ok) {
+                auto* assignment = static_cast<AssignmentNode*>(result.nodes[0].get());
+                unique_ptr<ASTNode> node = move(assignment->right);
+                while (auto* binary = dynamic_cast<BinaryOpNode*>(node.get())) {
+                    node = move(binary->left);
+                }
+            }
+        } catch (const GrammarError& error) {
+            cout << name << ": " << error.what() << endl;
+        }
+    }
+
+    // A left recursive rule is not LL(1) and is rejected with the conflict
+    try {
+        TableParser parser("expression = expression \"+\" NUMBER | NUMBER ;");
+    } catch (const GrammarError& error) {
+        cout << "left recursive grammar: " << error.what() << endl;
+    }
+
+    return 0;
+}
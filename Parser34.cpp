@@ -0,0 +1,458 @@
+// when a parse of a big file peaks we cannot tell where the memory went; route node, name, remaining input, memo table and scratch allocations through pluggable allocator hooks that count bytes per category with high water marks, and dump the counters from the driver
+
+
+#include <iostream>
+#include <string>
+#include <optional>
+#include <functional>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// What an allocation is for
+enum class MemoryCategory : uint8_t {
+    Nodes,    // AST nodes
+    Names,    // variable name strings
+    Input,    // copies of the remaining input made by the combinators
+    Memo,     // memo tables
+    Scratch,  // reusable scratch buffers
+    Count
+};
+
+const char* categoryName(MemoryCategory category) {
+    static const char* names[] = {"nodes", "names", "input", "memo", "scratch"};
+    return names[static_cast<size_t>(category)];
+}
+
+// Allocator hooks: every tracked allocation goes through these, so a caller
+// can plug in an arena, a debugging allocator or a failure injector
+struct AllocatorHooks {
+    void* (*allocate)(size_t bytes, MemoryCategory category);
+    void (*deallocate)(void* memory, size_t bytes, MemoryCategory category);
+};
+
+AllocatorHooks defaultHooks{
+    [](size_t bytes, MemoryCategory) -> void* { return malloc(bytes ? bytes : 1); },
+    [](void* memory, size_t, MemoryCategory) { free(memory); },
+};
+
+// Snapshot of the counters of one category
+struct CategoryStats {
+    uint64_t allocations;
+    uint64_t bytesAllocated;
+    uint64_t liveBytes;
+    uint64_t peakBytes;
+};
+
+// Live counters of one category
+struct CategoryCounters {
+    atomic<uint64_t> allocations{0};
+    atomic<uint64_t> bytesAllocated{0};
+    atomic<uint64_t> liveBytes{0};
+    atomic<uint64_t> peakBytes{0};
+};
+
+// Byte counters per category plus the hooks in use.
+class MemoryAccounting {
+public:
+    static void* allocate(size_t bytes, MemoryCategory category) {
+        void* memory = hooks.allocate(bytes, category);
+        if (!memory) throw bad_alloc();
+        CategoryCounters& counters = categories[static_cast<size_t>(category)];
+        counters.allocations.fetch_add(1, memory_order_relaxed);
+        counters.bytesAllocated.fetch_add(bytes, memory_order_relaxed);
+        raisePeak(counters.peakBytes, counters.liveBytes.fetch_add(bytes, memory_order_relaxed) + bytes);
+        raisePeak(totalPeak, totalLive.fetch_add(bytes, memory_order_relaxed) + bytes);
+        return memory;
+    }
+
+    static void deallocate(void* memory, size_t bytes, MemoryCategory category) {
+        if (!memory) return;
+        categories[static_cast<size_t>(category)].liveBytes.fetch_sub(bytes, memory_order_relaxed);
+        totalLive.fetch_sub(bytes, memory_order_relaxed);
+        hooks.deallocate(memory, bytes, category);
+    }
+
+    // Hooks must only be swapped while nothing tracked is alive, since memory
+    // has to be returned to the hooks that allocated it
+    static void setHooks(AllocatorHooks newHooks) {
+        hooks = newHooks;
+    }
+
+    static CategoryStats stats(MemoryCategory category) {
+        const CategoryCounters& counters = categories[static_cast<size_t>(category)];
+        return CategoryStats{counters.allocations.load(memory_order_relaxed), counters.bytesAllocated.load(memory_order_relaxed),
+                             counters.liveBytes.load(memory_order_relaxed), counters.peakBytes.load(memory_order_relaxed)};
+    }
+
+    static uint64_t peakBytes() {
+        return totalPeak.load(memory_order_relaxed);
+    }
+
+    // Start a new measurement: high water marks drop to what is live now
+    static void resetPeaks() {
+        for (auto& counters : categories) {
+            counters.peakBytes.store(counters.liveBytes.load(memory_order_relaxed), memory_order_relaxed);
+        }
+        totalPeak.store(totalLive.load(memory_order_relaxed), memory_order_relaxed);
+    }
+
+    static void report(ostream& out) {
+        out << left << setw(10) << "category" << right << setw(12) << "allocations" << setw(16) << "bytes" << setw(14)
+            << "live" << setw(14) << "peak" << endl;
+        for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); i++) {
+            CategoryStats category = stats(static_cast<MemoryCategory>(i));
+            out << left << setw(10) << categoryName(static_cast<MemoryCategory>(i)) << right << setw(12)
+                << category.allocations << setw(16) << category.bytesAllocated << setw(14) << category.liveBytes
+                << setw(14) << category.peakBytes << endl;
+        }
+        out << left << setw(10) << "all" << right << setw(42) << totalLive.load() << setw(14) << peakBytes() << endl;
+    }
+
+private:
+    static void raisePeak(atomic<uint64_t>& peak, uint64_t value) {
+        uint64_t current = peak.load(memory_order_relaxed);
+        while (value > current && !peak.compare_exchange_weak(current, value, memory_order_relaxed)) {
+        }
+    }
+
+    static inline AllocatorHooks hooks = defaultHooks;
+    static inline CategoryCounters categories[static_cast<size_t>(MemoryCategory::Count)];
+    static inline atomic<uint64_t> totalLive{0};
+    static inline atomic<uint64_t> totalPeak{0};
+};
+
+// Standard allocator that charges a category, for strings and containers
+template<typename T, MemoryCategory Category>
+struct TrackedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = TrackedAllocator<U, Category>;
+    };
+
+    TrackedAllocator() = default;
+    template<typename U>
+    TrackedAllocator(const TrackedAllocator<U, Category>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(MemoryAccounting::allocate(count * sizeof(T), Category));
+    }
+
+    void deallocate(T* memory, size_t count) {
+        MemoryAccounting::deallocate(memory, count * sizeof(T), Category);
+    }
+
+    template<typename U>
+    bool operator==(const TrackedAllocator<U, Category>&) const { return true; }
+    template<typename U>
+    bool operator!=(const TrackedAllocator<U, Category>&) const { return false; }
+};
+
+template<MemoryCategory Category>
+using TrackedString = basic_string<char, char_traits<char>, TrackedAllocator<char, Category>>;
+
+using Name = TrackedString<MemoryCategory::Names>;
+using Input = TrackedString<MemoryCategory::Input>;
+
+// Abstract syntax tree (AST) node classes. Nodes are charged to the nodes
+// category through class operator new; the sized delete sees the size of
+// the most derived class because the destructor is virtual.
+class ASTNode {
+public:
+    virtual ~ASTNode() = default;
+    virtual void print() const = 0;
+    virtual unique_ptr<ASTNode> clone() const = 0;
+
+    static void* operator new(size_t bytes) {
+        return MemoryAccounting::allocate(bytes, MemoryCategory::Nodes);
+    }
+    static void operator delete(void* memory, size_t bytes) {
+        MemoryAccounting::deallocate(memory, bytes, MemoryCategory::Nodes);
+    }
+};
+
+class VariableNode : public ASTNode {
+public:
+    Name name;
+    VariableNode(const Name& name) : name(name) {}
+    void print() const override {
+        cout << "Variable(" << name << ")";
+    }
+    unique_ptr<ASTNode> clone() const override {
+        return make_unique<VariableNode>(name);
+    }
+};
+
+class NumberNode : public ASTNode {
+public:
+    int value;
+    NumberNode(int value) : value(value) {}
+    void print() const override {
+        cout << "Number(" << value << ")";
+    }
+    unique_ptr<ASTNode> clone() const override {
+        return make_unique<NumberNode>(value);
+    }
+};
+
+class BinaryOpNode : public ASTNode {
+public:
+    char op;
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    BinaryOpNode(char op, unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : op(op), left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "BinaryOp(" << op << ", ";
+        left->print();
+        cout << ", ";
+        right->print();
+        cout << ")";
+    }
+    unique_ptr<ASTNode> clone() const override {
+        return make_unique<BinaryOpNode>(op, left->clone(), right->clone());
+    }
+};
+
+class AssignmentNode : public ASTNode {
+public:
+    unique_ptr<ASTNode> left;
+    unique_ptr<ASTNode> right;
+    AssignmentNode(unique_ptr<ASTNode> left, unique_ptr<ASTNode> right)
+        : left(move(left)), right(move(right)) {}
+    void print() const override {
+        cout << "Assignment(";
+        left->print();
+        cout << " = ";
+        right->print();
+        cout << ")";
+    }
+    unique_ptr<ASTNode> clone() const override {
+        return make_unique<AssignmentNode>(left->clone(), right->clone());
+    }
+};
+
+// Define a parser combinator function type. Each parser returns a copy of the
+// remaining input, and those copies are charged to the input category.
+using Parser = function<optional<pair<unique_ptr<ASTNode>, Input>>(const Input&)>;
+using ParseResult = optional<pair<unique_ptr<ASTNode>, Input>>;
+
+// Parser combinator function to parse a single character
+Parser charParser(char c) {
+    return [c](const Input& input) -> ParseResult {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(nullptr, input.substr(1)); // Return nullptr as the node for char parsing
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// OR combinator to combine multiple parsers
+template<typename... Parsers>
+Parser orParser(Parsers... parsers) {
+    vector<Parser> parserList = {parsers...};
+    return [parserList](const Input& input) -> ParseResult {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+Parser lexeme(Parser parser) {
+    return [parser](const Input& input) -> ParseResult {
+        size_t pos = 0;
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) {
+            pos++;
+        }
+        return parser(pos == 0 ? input : input.substr(pos));
+    };
+}
+
+// Memo entry of a rule at one position: the subtree and how much it consumed
+struct MemoEntry {
+    unique_ptr<ASTNode> tree;
+    size_t consumed;
+};
+
+// Memo table keyed by the length of the remaining input, which identifies a
+// position within one parse. Cleared by the caller between parses.
+using MemoTable = unordered_map<size_t, optional<MemoEntry>, hash<size_t>, equal_to<size_t>,
+                                TrackedAllocator<pair<const size_t, optional<MemoEntry>>, MemoryCategory::Memo>>;
+
+// Packrat combinator: a rule parsed again at the same position hands out a
+// copy of the memoized subtree instead of parsing it again. The table is
+// looked up on every call, so a thread_local table belongs to the thread
+// that is parsing, not to the one that built the grammar.
+Parser memoParser(Parser parser, MemoTable& (*table)()) {
+    return [parser, table](const Input& input) -> ParseResult {
+        MemoTable& memo = table();
+        if (auto it = memo.find(input.size()); it != memo.end()) {
+            if (!it->second) return nullopt;
+            return make_pair(it->second->tree->clone(), input.substr(it->second->consumed));
+        }
+        auto result = parser(input);
+        if (!result) {
+            memo.emplace(input.size(), nullopt);
+            return nullopt;
+        }
+        memo.emplace(input.size(), MemoEntry{result->first->clone(), input.size() - result->second.size()});
+        return result;
+    };
+}
+
+// Chain combinator for left recursive rules: operand (op operand)*
+Parser chainLeftParser(Parser operand, char op) {
+    Parser operatorParser = lexeme(charParser(op));
+    return [operand, operatorParser, op](const Input& input) -> ParseResult {
+        auto result = operand(input);
+        if (!result) return nullopt;
+        unique_ptr<ASTNode> tree = move(result->first);
+        Input remaining = move(result->second);
+        while (auto operatorResult = operatorParser(remaining)) {
+            auto operandResult = operand(operatorResult->second);
+            if (!operandResult) break;
+            tree = make_unique<BinaryOpNode>(op, move(tree), move(operandResult->first));
+            remaining = move(operandResult->second);
+        }
+        return make_pair(move(tree), move(remaining));
+    };
+}
+
+// Scratch buffer the variable parser collects name characters in; it keeps
+// its capacity between calls, so it is charged once, not per name
+thread_local vector<char, TrackedAllocator<char, MemoryCategory::Scratch>> nameScratch;
+
+// Parser for variable names
+Parser variableParser = [](const Input& input) -> ParseResult {
+    if (input.empty() || !isalpha(static_cast<unsigned char>(input[0]))) {
+        return nullopt;
+    }
+    nameScratch.clear();
+    size_t pos = 0;
+    while (pos < input.size() && (isalnum(static_cast<unsigned char>(input[pos])) || input[pos] == '_')) {
+        nameScratch.push_back(input[pos]);
+        pos++;
+    }
+    return make_pair(make_unique<VariableNode>(Name(nameScratch.begin(), nameScratch.end())), input.substr(pos));
+};
+
+// Parser for numbers (sequence of digits)
+Parser numberParser = [](const Input& input) -> ParseResult {
+    size_t pos = 0;
+    while (pos < input.size() && isdigit(static_cast<unsigned char>(input[pos]))) {
+        pos++;
+    }
+    int value = 0;
+    if (pos == 0 || from_chars(input.data(), input.data() + pos, value).ec != errc()) {
+        return nullopt;
+    }
+    return make_pair(make_unique<NumberNode>(value), input.substr(pos));
+};
+
+// Terms are memoized: a statement is tried as an assignment first and as an
+// expression second, and both start with the same term
+MemoTable& termMemo() {
+    thread_local MemoTable memo;
+    return memo;
+}
+
+Parser termParser = memoParser(lexeme(orParser(numberParser, variableParser)), termMemo);
+
+// Parser for expressions: expr := expr '+' term | term
+Parser expressionParser = chainLeftParser(termParser, '+');
+
+// Parser for assignment (variable = expression)
+Parser assignmentParser = [](const Input& input) -> ParseResult {
+    auto variableResult = lexeme(variableParser)(input);
+    if (!variableResult) return nullopt;
+    auto equalsResult = lexeme(charParser('='))(variableResult->second);
+    if (!equalsResult) return nullopt;
+    auto expressionResult = expressionParser(equalsResult->second);
+    if (!expressionResult) return nullopt;
+    return make_pair(make_unique<AssignmentNode>(move(variableResult->first), move(expressionResult->first)),
+                     move(expressionResult->second));
+};
+
+// Parser for a statement: an assignment or a bare expression, then ';'
+Parser statementParser = [](const Input& input) -> ParseResult {
+    termMemo().clear();
+    auto result = orParser(assignmentParser, expressionParser)(input);
+    if (!result) return nullopt;
+    auto semicolon = lexeme(charParser(';'))(result->second);
+    if (!semicolon) return nullopt;
+    return make_pair(move(result->first), move(semicolon->second));
+};
+
+// Parse a program; a statement that fails is skipped up to its ';'
+vector<unique_ptr<ASTNode>> parseProgram(Input input, size_t& errors) {
+    vector<unique_ptr<ASTNode>> statements;
+    while (input.find_first_not_of(" \t\r\n") != Input::npos) {
+        if (auto result = statementParser(input); result) {
+            statements.push_back(move(result->first));
+            input = move(result->second);
+        } else {
+            errors++;
+            size_t end = input.find(';');
+            input = end == Input::npos ? Input() : input.substr(end + 1);
+        }
+    }
+    termMemo().clear();
+    return statements;
+}
+
+// Test the parser and dump the memory counters
+int main(int argc, char* argv[]) {
+    // A debugging hook: freed memory is filled with a pattern so that a use
+    // after free shows up as garbage instead of plausible data
+    MemoryAccounting::setHooks(AllocatorHooks{
+        defaultHooks.allocate,
+        [](void* memory, size_t bytes, MemoryCategory) {
+            memset(memory, 0xdd, bytes);
+            free(memory);
+        },
+    });
+
+    size_t errors = 0;
+    auto statements = parseProgram("x = 42 + y_2; y_2 + 7; z = ;", errors);
+    for (const auto& statement : statements) {
+        cout << "Parsed: ";
+        statement->print();
+        cout << endl;
+    }
+    cout << errors << " errors" << endl;
+    statements.clear();
+
+    size_t count = argc > 1 ? stoul(argv[1]) : 2000;
+    Input program;
+    for (size_t i = 0; i < count; i++) {
+        program += "variable_with_long_name_" + to_string(i) + " = " + to_string(i) + " + y_2 + offset;\n";
+        program += "offset + " + to_string(i) + ";\n";
+    }
+
+    MemoryAccounting::resetPeaks();
+    statements = parseProgram(program, errors);
+    cout << endl << "After parsing " << statements.size() << " statements from " << program.size() << " bytes:" << endl;
+    MemoryAccounting::report(cout);
+
+    statements.clear();
+    cout << endl << "After freeing the trees:" << endl;
+    MemoryAccounting::report(cout);
+
+    return 0;
+}
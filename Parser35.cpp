@@ -0,0 +1,526 @@
+// tools built on the parser rescan the text to find where a node came from; record a compact 32 bit offset and length span for every node and statement in a column of the flat AST, outside the hot node columns, plus an offset to line index built once per file
+
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// 256-bit set of characters that can be built and queried at compile time
+class CharSet {
+public:
+    constexpr CharSet() = default;
+
+    // Implicit so that a plain character can be used in a | expression, e.g. charset<'a', 'z'> | '_'
+    constexpr CharSet(char c) {
+        insert(static_cast<unsigned char>(c));
+    }
+
+    static constexpr CharSet range(char first, char last) {
+        CharSet set;
+        for (int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); c++) {
+            set.insert(static_cast<unsigned char>(c));
+        }
+        return set;
+    }
+
+    constexpr bool contains(unsigned char c) const {
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    friend constexpr CharSet operator|(CharSet a, CharSet b) {
+        CharSet set;
+        for (int i = 0; i < 4; i++) {
+            set.bits[i] = a.bits[i] | b.bits[i];
+        }
+        return set;
+    }
+
+private:
+    constexpr void insert(unsigned char c) {
+        bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    uint64_t bits[4] = {0, 0, 0, 0};
+};
+
+// Compile-time character range, e.g. charset<'a', 'z'>
+template<char First, char Last>
+constexpr CharSet charset = CharSet::range(First, Last);
+
+// Character classes used by the grammar
+constexpr CharSet letters = charset<'a', 'z'> | charset<'A', 'Z'>;
+constexpr CharSet digits = charset<'0', '9'>;
+constexpr CharSet identifierChars = letters | digits | '_';
+constexpr CharSet spaces = CharSet(' ') | '\t' | '\n' | '\r';
+
+// Result of a parser producing a T: the value and the remaining input
+template<typename T>
+using Result = optional<pair<T, string_view>>;
+
+// Define a parser combinator function type, generic over the result type.
+// The input is a view, so consuming characters never copies the rest of it.
+template<typename T>
+using Parser = function<Result<T>(string_view)>;
+
+// Value of rules that only recognize input
+struct Unit {};
+
+// Parser combinator function to parse a single character
+Parser<char> charParser(char c) {
+    return [c](string_view input) -> Result<char> {
+        if (!input.empty() && input[0] == c) {
+            return make_pair(c, input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Parser combinator function to parse any character of a set
+Parser<char> charSetParser(CharSet set) {
+    return [set](string_view input) -> Result<char> {
+        if (!input.empty() && set.contains(static_cast<unsigned char>(input[0]))) {
+            return make_pair(input[0], input.substr(1));
+        } else {
+            return nullopt;
+        }
+    };
+}
+
+// Map combinator: transform the value of a successful parse
+template<typename T, typename F>
+auto mapParser(Parser<T> parser, F f) -> Parser<decltype(f(declval<T>()))> {
+    using U = decltype(f(declval<T>()));
+    return [parser, f](string_view input) -> Result<U> {
+        if (auto result = parser(input); result) {
+            return make_pair(f(move(result->first)), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Sequence combinator: run the parsers one after another and collect their values in a tuple
+template<typename T, typename... Ts>
+Parser<tuple<T, Ts...>> seqParser(Parser<T> first, Parser<Ts>... rest) {
+    if constexpr (sizeof...(Ts) == 0) {
+        return mapParser(first, [](T value) { return tuple<T>(move(value)); });
+    } else {
+        Parser<tuple<Ts...>> others = seqParser(rest...);
+        return [first, others](string_view input) -> Result<tuple<T, Ts...>> {
+            auto firstResult = first(input);
+            if (!firstResult) return nullopt;
+
+            auto othersResult = others(firstResult->second);
+            if (!othersResult) return nullopt;
+
+            return make_pair(tuple_cat(tuple<T>(move(firstResult->first)), move(othersResult->first)),
+                             othersResult->second);
+        };
+    }
+}
+
+// OR combinator to combine multiple parsers of the same result type
+template<typename T, typename... Parsers>
+Parser<T> orParser(Parser<T> first, Parsers... rest) {
+    // Copy the parsers into a vector so the closure owns them
+    vector<Parser<T>> parserList = {first, rest...};
+    return [parserList](string_view input) -> Result<T> {
+        for (const auto& parser : parserList) {
+            if (auto result = parser(input); result) {
+                return result;
+            }
+        }
+        return nullopt;
+    };
+}
+
+// Skip combinator: run the parser and drop its value
+template<typename T>
+Parser<Unit> skipParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        if (auto result = parser(input); result) {
+            return make_pair(Unit{}, result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Skip zero or more repetitions of a parser without collecting anything
+template<typename T>
+Parser<Unit> skipManyParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<Unit> {
+        while (auto result = parser(input)) {
+            if (result->second.size() == input.size()) break;
+            input = result->second;
+        }
+        return make_pair(Unit{}, input);
+    };
+}
+
+// Run ignored first, then parser, keeping only the value of parser
+template<typename T, typename U>
+Parser<U> ignoreThen(Parser<T> ignored, Parser<U> parser) {
+    return [ignored, parser](string_view input) -> Result<U> {
+        auto ignoredResult = ignored(input);
+        if (!ignoredResult) return nullopt;
+        return parser(ignoredResult->second);
+    };
+}
+
+// Span combinator: the value is the text the parser consumed, not whatever it built
+template<typename T>
+Parser<string_view> spanParser(Parser<T> parser) {
+    return [parser](string_view input) -> Result<string_view> {
+        if (auto result = parser(input); result) {
+            size_t length = input.size() - result->second.size();
+            return make_pair(input.substr(0, length), result->second);
+        }
+        return nullopt;
+    };
+}
+
+// Token combinator: skip leading whitespace, then run the parser
+template<typename T>
+Parser<T> lexeme(Parser<T> parser) {
+    return ignoreThen(skipManyParser(charSetParser(spaces)), parser);
+}
+
+// Chain combinator for left recursive rules: operand (op operand)*, folded with combine
+template<typename T, typename F>
+Parser<T> chainLeftParser(Parser<T> operand, Parser<char> op, F combine) {
+    return [operand, op, combine](string_view input) -> Result<T> {
+        auto result = operand(input);
+        if (!result) return nullopt;
+
+        T value = move(result->first);
+        string_view remaining = result->second;
+        while (auto opResult = op(remaining)) {
+            auto operandResult = operand(opResult->second);
+            if (!operandResult) break;
+            value = combine(opResult->first, move(value), move(operandResult->first));
+            remaining = operandResult->second;
+        }
+        return make_pair(move(value), remaining);
+    };
+}
+
+// Run parser, then ignored, keeping only the value of parser
+template<typename T, typename U>
+Parser<T> thenIgnore(Parser<T> parser, Parser<U> ignored) {
+    return [parser, ignored](string_view input) -> Result<T> {
+        auto result = parser(input);
+        if (!result) return nullopt;
+        auto ignoredResult = ignored(result->second);
+        if (!ignoredResult) return nullopt;
+        return make_pair(move(result->first), ignoredResult->second);
+    };
+}
+
+// Take the longest prefix of characters in a set. The value is a span of the
+// input, so no container is involved at all.
+Parser<string_view> takeWhileParser(CharSet set, size_t minimum = 0) {
+    return [set, minimum](string_view input) -> Result<string_view> {
+        size_t length = 0;
+        while (length < input.size() && set.contains(static_cast<unsigned char>(input[length]))) {
+            length++;
+        }
+        if (length < minimum) return nullopt;
+        return make_pair(input.substr(0, length), input.substr(length));
+    };
+}
+
+// Character level rules: spans of the input, no per character loop building a string
+Parser<string_view> identifierParser = spanParser(seqParser(charSetParser(letters), takeWhileParser(identifierChars)));
+Parser<string_view> digitsParser = takeWhileParser(digits, 1);
+
+// Kinds of expression nodes in the columnar store
+enum class NodeKind : uint8_t {
+    Variable = 1,
+    Number = 2,
+    BinaryOp = 3
+};
+
+// Where a node or statement came from: a byte range of the source. Two
+// 32-bit fields keep it at 8 bytes, which limits a source to 4 GiB.
+struct SourceSpan {
+    uint32_t offset;
+    uint32_t length;
+
+    uint32_t end() const { return offset + length; }
+};
+
+// Columnar sink for a parsed program. Rather than one heap tree per statement,
+// every field is its own contiguous column, so a consumer can bulk load a
+// whole column with a single copy. Ids are indices into the columns.
+struct ProgramColumns {
+    // The parsed source; name views and spans refer to it, so it must outlive the sink
+    string_view source;
+
+    explicit ProgramColumns(string_view source) : source(source) {
+        if (source.size() > UINT32_MAX) {
+            throw length_error("source larger than 4 GiB cannot be addressed by 32-bit spans");
+        }
+    }
+
+    // Interned variable names
+    vector<string_view> names;
+    unordered_map<string_view, uint32_t> nameIds;
+
+    // Expression nodes. For Variable nodes left is the name id, for Number
+    // nodes it is the value, for BinaryOp nodes left and right are node ids.
+    vector<NodeKind> nodeKinds;
+    vector<char> nodeOps;
+    vector<uint32_t> nodeLeft;
+    vector<uint32_t> nodeRight;
+
+    // Source span of each node. It is a column of its own, so walks over the
+    // tree never pull spans into the cache; only source mapping touches it.
+    vector<SourceSpan> nodeSpans;
+
+    // One row per assignment: the target, the value, the span of the whole
+    // statement up to but excluding the ';', and the span of the target name
+    vector<uint32_t> targetNames;
+    vector<uint32_t> expressionRoots;
+    vector<SourceSpan> statementSpans;
+    vector<SourceSpan> targetSpans;
+
+    uint32_t internName(string_view name) {
+        auto [it, inserted] = nameIds.try_emplace(name, static_cast<uint32_t>(names.size()));
+        if (inserted) {
+            names.push_back(name);
+        }
+        return it->second;
+    }
+
+    // Span of a view into the source
+    SourceSpan spanOf(string_view text) const {
+        return SourceSpan{static_cast<uint32_t>(text.data() - source.data()), static_cast<uint32_t>(text.size())};
+    }
+
+    string_view text(SourceSpan span) const {
+        return source.substr(span.offset, span.length);
+    }
+
+    uint32_t addNode(NodeKind kind, char op, uint32_t left, uint32_t right, SourceSpan span) {
+        nodeKinds.push_back(kind);
+        nodeOps.push_back(op);
+        nodeLeft.push_back(left);
+        nodeRight.push_back(right);
+        nodeSpans.push_back(span);
+        return static_cast<uint32_t>(nodeKinds.size() - 1);
+    }
+
+    // Drop nodes and names added by a statement that failed to parse
+    void rollback(size_t count, size_t nameCount) {
+        while (names.size() > nameCount) {
+            nameIds.erase(names.back());
+            names.pop_back();
+        }
+        nodeKinds.resize(count);
+        nodeOps.resize(count);
+        nodeLeft.resize(count);
+        nodeRight.resize(count);
+        nodeSpans.resize(count);
+    }
+
+    void reserve(size_t statements, size_t nodes) {
+        targetNames.reserve(statements);
+        expressionRoots.reserve(statements);
+        statementSpans.reserve(statements);
+        targetSpans.reserve(statements);
+        nodeKinds.reserve(nodes);
+        nodeOps.reserve(nodes);
+        nodeLeft.reserve(nodes);
+        nodeRight.reserve(nodes);
+        nodeSpans.reserve(nodes);
+    }
+
+    size_t statementCount() const { return targetNames.size(); }
+    size_t nodeCount() const { return nodeKinds.size(); }
+
+    // Print an expression; the left spine is walked in a loop, so long chains do not recurse deeply
+    void printExpression(uint32_t node) const {
+        vector<uint32_t> rights;
+        while (nodeKinds[node] == NodeKind::BinaryOp) {
+            rights.push_back(node);
+            node = nodeLeft[node];
+        }
+        printLeaf(node);
+        while (!rights.empty()) {
+            cout << " " << nodeOps[rights.back()] << " ";
+            printExpression(nodeRight[rights.back()]);
+            rights.pop_back();
+        }
+    }
+
+    void printLeaf(uint32_t node) const {
+        if (nodeKinds[node] == NodeKind::Variable) {
+            cout << names[nodeLeft[node]];
+        } else {
+            cout << nodeLeft[node];
+        }
+    }
+};
+
+// Line and column of a source offset, both counted from 1
+struct SourcePosition {
+    uint32_t line;
+    uint32_t column;
+};
+
+// Offsets at which lines start, found with one memchr pass over the file.
+// Mapping an offset to a line is then a binary search, not a rescan.
+class LineIndex {
+public:
+    explicit LineIndex(string_view source) {
+        lineStarts.push_back(0);
+        const char* begin = source.data();
+        const char* end = begin + source.size();
+        for (const char* p = begin; (p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr; p++) {
+            lineStarts.push_back(static_cast<uint32_t>(p + 1 - begin));
+        }
+    }
+
+    SourcePosition position(uint32_t offset) const {
+        auto line = upper_bound(lineStarts.begin(), lineStarts.end(), offset) - 1;
+        return SourcePosition{static_cast<uint32_t>(line - lineStarts.begin() + 1), offset - *line + 1};
+    }
+
+    size_t lineCount() const { return lineStarts.size(); }
+
+private:
+    vector<uint32_t> lineStarts;
+};
+
+// Statement rules write node ids into the sink instead of returning nodes.
+// Leaves take their span from the token; a BinaryOp spans from the start of
+// its left operand to the end of its right one.
+Parser<uint32_t> expressionParser(ProgramColumns& sink) {
+    Parser<uint32_t> variableParser = mapParser(identifierParser, [&sink](string_view name) {
+        return sink.addNode(NodeKind::Variable, 0, sink.internName(name), 0, sink.spanOf(name));
+    });
+    // A literal that does not fit the column fails the statement
+    Parser<uint32_t> numberParser = [&sink](string_view input) -> Result<uint32_t> {
+        auto digitsResult = digitsParser(input);
+        if (!digitsResult) return nullopt;
+        string_view text = digitsResult->first;
+        uint32_t value = 0;
+        if (from_chars(text.data(), text.data() + text.size(), value).ec != errc()) return nullopt;
+        return make_pair(sink.addNode(NodeKind::Number, 0, value, 0, sink.spanOf(text)), digitsResult->second);
+    };
+    Parser<uint32_t> termParser = lexeme(orParser(numberParser, variableParser));
+    return chainLeftParser(termParser, lexeme(charParser('+')), [&sink](char op, uint32_t left, uint32_t right) {
+        SourceSpan first = sink.nodeSpans[left];
+        SourceSpan last = sink.nodeSpans[right];
+        return sink.addNode(NodeKind::BinaryOp, op, left, right, SourceSpan{first.offset, last.end() - first.offset});
+    });
+}
+
+// program := (assignment ';')*
+// Returns the number of statements appended to the sink. Parsing stops at the
+// first statement that does not match; the remaining input tells where.
+Parser<size_t> programParser(ProgramColumns& sink) {
+    Parser<string_view> targetParser = lexeme(identifierParser);
+    Parser<char> equalsParser = lexeme(charParser('='));
+    Parser<char> semicolonParser = lexeme(charParser(';'));
+    Parser<uint32_t> valueParser = expressionParser(sink);
+
+    return [=, &sink](string_view input) -> Result<size_t> {
+        size_t statements = 0;
+        while (true) {
+            size_t nodeMark = sink.nodeCount();
+            size_t nameMark = sink.names.size();
+            auto target = targetParser(input);
+            if (!target) break;
+            auto equals = equalsParser(target->second);
+            if (!equals) break;
+            auto value = valueParser(equals->second);
+            auto semicolon = value ? semicolonParser(value->second) : nullopt;
+            if (!semicolon) {
+                sink.rollback(nodeMark, nameMark);
+                break;
+            }
+
+            SourceSpan targetSpan = sink.spanOf(target->first);
+            sink.targetNames.push_back(sink.internName(target->first));
+            sink.expressionRoots.push_back(value->first);
+            sink.statementSpans.push_back(SourceSpan{targetSpan.offset, sink.nodeSpans[value->first].end() - targetSpan.offset});
+            sink.targetSpans.push_back(targetSpan);
+            statements++;
+            input = semicolon->second;
+        }
+        return make_pair(statements, input);
+    };
+}
+
+// Test the parser
+int main() {
+    string_view program = "x = 42 + y_2;\ntotal = x +\n    x + 7;\ny_2 = 1; broken = ;";
+
+    ProgramColumns columns(program);
+    LineIndex lines(program);
+    if (auto result = programParser(columns)(program); result) {
+        for (size_t i = 0; i < columns.statementCount(); i++) {
+            SourcePosition at = lines.position(columns.statementSpans[i].offset);
+            cout << at.line << ":" << at.column << " " << columns.names[columns.targetNames[i]] << " = ";
+            columns.printExpression(columns.expressionRoots[i]);
+            cout << "  [\"" << columns.text(columns.statementSpans[i]) << "\"]" << endl;
+        }
+        SourcePosition stop = lines.position(static_cast<uint32_t>(program.size() - result->second.size()));
+        cout << "Stopped at " << stop.line << ":" << stop.column << endl;
+    }
+
+    // Every use of x, found from the span column alone
+    uint32_t x = columns.nameIds.at("x");
+    for (uint32_t node = 0; node < columns.nodeCount(); node++) {
+        if (columns.nodeKinds[node] == NodeKind::Variable && columns.nodeLeft[node] == x) {
+            SourcePosition at = lines.position(columns.nodeSpans[node].offset);
+            cout << "x used at " << at.line << ":" << at.column << endl;
+        }
+    }
+
+    // Map every node of a large program back to its line and column
+    string source;
+    size_t statements = 500000;
+    for (size_t i = 0; i < statements; i++) {
+        source += "v" + to_string(i) + " = v" + to_string(i / 2) + " + " + to_string(i % 97) + ";\n";
+    }
+
+    ProgramColumns big(source);
+    big.reserve(statements, statements * 3);
+    auto start = chrono::steady_clock::now();
+    auto result = programParser(big)(source);
+    auto parsed = chrono::steady_clock::now();
+    LineIndex bigLines(source);
+    auto indexed = chrono::steady_clock::now();
+
+    uint64_t lineSum = 0;
+    for (const SourceSpan& span : big.nodeSpans) {
+        lineSum += bigLines.position(span.offset).line;
+    }
+    auto mapped = chrono::steady_clock::now();
+
+    cout << "Parsed " << (result ? result->first : 0) << " statements, " << big.nodeCount() << " nodes in "
+         << chrono::duration_cast<chrono::milliseconds>(parsed - start).count() << " ms; spans take "
+         << big.nodeSpans.size() * sizeof(SourceSpan) / 1024 << " KiB" << endl;
+    cout << "Line index of " << bigLines.lineCount() << " lines built in "
+         << chrono::duration_cast<chrono::microseconds>(indexed - parsed).count() << " us; mapped every node in "
+         << chrono::duration_cast<chrono::milliseconds>(mapped - indexed).count() << " ms (line sum " << lineSum << ")" << endl;
+
+    return 0;
+}